@@ -0,0 +1,26 @@
+#!/bin/bash
+# Measure how games/sec scales with concurrency using benchmark.json
+# Usage: ./benchmark.sh path/to/cuteataxx-cli [max_concurrency]
+
+set -e
+
+if [ -z "$1" ]; then
+    echo "Usage: $0 path/to/cuteataxx-cli [max_concurrency]"
+    exit 1
+fi
+
+cli=$(realpath "$1")
+max_concurrency=${2:-128}
+
+cd "$(dirname "$0")"
+settings=$(mktemp --suffix=.json -p .)
+trap 'rm -f "$settings"' EXIT
+
+echo "threads games/sec"
+concurrency=1
+while [ "$concurrency" -le "$max_concurrency" ]; do
+    sed "s/\"concurrency\": [0-9]*/\"concurrency\": $concurrency/" benchmark.json > "$settings"
+    rate=$("$cli" "$settings" | grep "games/sec" | awk '{print $2}')
+    printf "%7d %s\n" "$concurrency" "$rate"
+    concurrency=$((concurrency * 2))
+done
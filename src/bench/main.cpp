@@ -0,0 +1,250 @@
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <libataxx/position.hpp>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "core/ataxx/adjudicate.hpp"
+#include "core/binary.hpp"
+#include "core/engine/process.hpp"
+#include "core/parse/pgn.hpp"
+#include "core/pgn.hpp"
+
+// Time the adjudication checks made before every move, over every position from a file of real games
+// Usage: cuteataxx-bench [games]
+// Or time sending a line to an engine and reading the reply, with an engine that repeats every line back
+// Usage: cuteataxx-bench --pipe [echo engine]
+
+// How long to keep repeating the checks for, to get a stable time
+constexpr auto min_duration = std::chrono::seconds(2);
+
+// A typical line of engine output
+constexpr auto echo_line =
+    std::string_view("info depth 12 score cp 35 nodes 1234567 nps 2345678 time 526 pv f1e2 a7b6");
+// How many lines to send at once when timing throughput, roughly the info lines an engine sends per move
+constexpr std::size_t burst_size = 64;
+
+// Talks to anything that repeats each line it's sent, such as cat
+class EchoEngine final : public ProcessEngine {
+   public:
+    [[nodiscard]] EchoEngine(const std::string &path) : ProcessEngine(path, "") {
+    }
+
+    using ProcessEngine::position;
+
+    // Send every line before reading any of the replies
+    // Returns the number of bytes read back
+    [[nodiscard]] auto echo(const std::size_t num_lines) -> std::size_t {
+        for (std::size_t i = 0; i < num_lines; ++i) {
+            send(echo_line);
+        }
+
+        std::size_t num_bytes = 0;
+        for (std::size_t i = 0; i < num_lines; ++i) {
+            const auto line = get_output();
+            if (line.empty()) {
+                throw std::runtime_error("Echo engine stopped replying");
+            }
+            num_bytes += line.size();
+        }
+        return num_bytes;
+    }
+
+    [[nodiscard]] virtual auto go(const SearchSettings &) -> std::string override {
+        return {};
+    }
+
+    virtual auto init() -> void override {
+    }
+
+    virtual auto position(const libataxx::Position &) -> void override {
+    }
+
+    virtual auto set_option(const std::string &, const std::string &) -> void override {
+    }
+
+    virtual auto isready() -> void override {
+    }
+
+    virtual auto newgame() -> void override {
+    }
+
+    virtual auto quit() -> void override {
+    }
+
+    virtual auto stop() -> void override {
+    }
+};
+
+// Time how long it takes to echo lines in groups of lines_per_trip
+// Returns the nanoseconds per line
+[[nodiscard]] auto time_echo(EchoEngine &engine, const std::size_t lines_per_trip) -> double {
+    std::uint64_t num_lines = 0;
+    // Counted so the reads can't be optimised away
+    std::uint64_t num_bytes = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    auto t1 = t0;
+    while (t1 - t0 < min_duration) {
+        for (int i = 0; i < 100; ++i) {
+            num_bytes += engine.echo(lines_per_trip);
+        }
+        num_lines += 100 * lines_per_trip;
+        t1 = std::chrono::steady_clock::now();
+    }
+
+    if (num_bytes != num_lines * echo_line.size()) {
+        throw std::runtime_error("Echo engine replied with something else");
+    }
+
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    return static_cast<double>(ns) / static_cast<double>(num_lines);
+}
+
+[[nodiscard]] auto bench_pipe(const std::string &path) -> int {
+    try {
+        auto engine = EchoEngine(path);
+        const auto roundtrip = time_echo(engine, 1);
+        const auto burst = time_echo(engine, burst_size);
+        std::cout << "ns/roundtrip " << roundtrip << "\n";
+        std::cout << "ns/line " << burst << "\n";
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
+
+[[nodiscard]] auto is_binary_path(const std::string &path) -> bool {
+    return path.ends_with(".bin");
+}
+
+[[nodiscard]] auto game_positions(const GameThingy &game) -> std::vector<libataxx::Position> {
+    std::vector<libataxx::Position> positions;
+    auto pos = game.startpos;
+    positions.push_back(pos);
+    for (const auto &move : game.history) {
+        if (!pos.is_legal_move(move.move)) {
+            break;
+        }
+        pos.makemove(move.move);
+        positions.push_back(pos);
+    }
+
+    return positions;
+}
+
+// The positions of each game, kept apart since games remember what adjudication has already tried
+[[nodiscard]] auto read_positions(std::istream &is, const bool binary) -> std::vector<std::vector<libataxx::Position>> {
+    std::vector<std::vector<libataxx::Position>> positions;
+
+    if (binary) {
+        auto reader = BinaryReader(is);
+        auto game = BinaryGame{};
+        while (reader.next(game)) {
+            positions.push_back(game_positions(game.game));
+        }
+    } else {
+        parse::pgn(is, PGNSettings{}, [&](const parse::PGNGame &game) {
+            positions.push_back(game_positions(game.game));
+        });
+    }
+
+    return positions;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " [games]\n";
+        std::cerr << "Times the adjudication checks made before every move, over the positions in a .pgn or .bin\n";
+        std::cerr << "Usage: " << argv[0] << " --pipe [echo engine]\n";
+        std::cerr << "Times sending lines to an engine that repeats them back, /bin/cat by default\n";
+        return 1;
+    }
+
+    if (std::string(argv[1]) == "--pipe") {
+        return bench_pipe(argc > 2 ? argv[2] : "/bin/cat");
+    }
+
+    const std::string input = argv[1];
+
+    std::ifstream is(input, std::ios::binary);
+    if (!is.is_open()) {
+        std::cerr << "Failed to open " << input << "\n";
+        return 1;
+    }
+
+    std::vector<std::vector<libataxx::Position>> positions;
+    try {
+        positions = read_positions(is, is_binary_path(input));
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    // The same as res/settings.json, with solving turned on as well
+    const auto settings = AdjudicationSettings{300, 30, true, 0, 4};
+
+    // Games only try adjudicating positions that aren't already over
+    std::vector<std::vector<libataxx::Position>> playable;
+    std::size_t num_positions = 0;
+    std::size_t num_playable = 0;
+    std::map<ResultReason, std::size_t> counts;
+    for (const auto &game : positions) {
+        auto state = AdjudicationState{};
+        playable.emplace_back();
+        num_positions += game.size();
+
+        for (const auto &pos : game) {
+            if (pos.is_gameover()) {
+                counts[ResultReason::Normal]++;
+                continue;
+            }
+
+            playable.back().push_back(pos);
+            if (const auto adjudication = adjudicate(pos, settings, state)) {
+                counts[adjudication->reason]++;
+            }
+        }
+
+        num_playable += playable.back().size();
+    }
+
+    if (num_playable == 0) {
+        std::cerr << "No positions found\n";
+        return 1;
+    }
+
+    std::uint64_t checks = 0;
+    // Counted so the checks can't be optimised away
+    std::uint64_t num_adjudicated = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    auto t1 = t0;
+    while (t1 - t0 < min_duration) {
+        for (const auto &game : playable) {
+            auto state = AdjudicationState{};
+            for (const auto &pos : game) {
+                num_adjudicated += adjudicate(pos, settings, state).has_value();
+            }
+        }
+        checks += num_playable;
+        t1 = std::chrono::steady_clock::now();
+    }
+
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+
+    std::cout << "positions " << num_positions << "\n";
+    std::cout << "game over " << counts[ResultReason::Normal] << "\n";
+    std::cout << "material " << counts[ResultReason::MaterialImbalance] << "\n";
+    std::cout << "easyfill " << counts[ResultReason::EasyFill] << "\n";
+    std::cout << "gamelength " << counts[ResultReason::Gamelength] << "\n";
+    std::cout << "solved " << counts[ResultReason::Solved] << "\n";
+    std::cout << "adjudicated " << num_adjudicated * num_playable / checks << "\n";
+    std::cout << "ns/ply " << static_cast<double>(ns) / static_cast<double>(checks) << "\n";
+
+    return 0;
+}
@@ -1,4 +1,7 @@
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <ctime>
 #include <elo.hpp>
 #include <fstream>
 #include <iomanip>
@@ -8,11 +11,38 @@
 #include <thread>
 #include "core/engine/engine.hpp"
 #include "core/match/callbacks.hpp"
+#include "core/match/checkpoint.hpp"
+#include "core/match/coordinator.hpp"
+#include "core/match/cores.hpp"
+#include "core/match/llr.hpp"
+#include "core/match/node.hpp"
 #include "core/match/run.hpp"
 #include "core/match/settings.hpp"
+#include "core/opening_book.hpp"
 #include "core/parse/openings.hpp"
 #include "core/parse/settings.hpp"
 
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// The most memory cuteataxx itself has used so far in kilobytes, engine processes aren't included
+[[nodiscard]] auto peak_memory_kb() -> std::int64_t {
+#ifdef _WIN32
+    return 0;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
 [[nodiscard]] auto create_callbacks(const Settings &settings) -> Callbacks {
     auto callbacks = Callbacks{};
 
@@ -45,7 +75,12 @@
     }
 
     // Always print results
-    callbacks.on_results_update = [&settings](const Results &results) {
+    // Several games can finish between updates, so print whenever we cross a rating interval
+    callbacks.on_results_update = [&settings, last_printed = 0](const Results &results) mutable {
+        const auto is_print_late =
+            results.games_played / settings.ratinginterval > last_printed / settings.ratinginterval;
+        last_printed = results.games_played;
+
         if (settings.engines.size() == 2) {
             const auto &e1 = settings.engines.at(0);
             const auto &e2 = settings.engines.at(1);
@@ -54,14 +89,13 @@
             const auto d = results.scores.at(e1.name).draws;
             const auto elo = get_elo(w, l, d);
             const auto err = get_err(w, l, d);
-            const auto llr = sprt::get_llr(w, l, d, settings.sprt.elo0, settings.sprt.elo1);
+            const auto llr = match_llr(settings, results);
             const auto lbound = sprt::get_lbound(settings.sprt.alpha, settings.sprt.beta);
             const auto ubound = sprt::get_ubound(settings.sprt.alpha, settings.sprt.beta);
 
             const auto is_sprt_stop =
                 settings.sprt.enabled && settings.sprt.autostop && (llr <= lbound || llr >= ubound);
             const auto is_print_early = results.games_played < settings.ratinginterval && settings.print_early;
-            const auto is_print_late = results.games_played % settings.ratinginterval == 0;
             const auto is_complete = settings.num_games == results.games_played;
 
             const auto print_result = is_print_early || is_print_late || is_sprt_stop || is_complete;
@@ -93,7 +127,14 @@
 
             // Print SPRT
             if (print_sprt) {
-                std::cout << "SPRT: llr " << llr << ", lbound " << lbound << ", ubound " << ubound << "\n";
+                std::cout << "SPRT: llr " << llr << ", lbound " << lbound << ", ubound " << ubound;
+                if (settings.sprt.pentanomial) {
+                    std::cout << ", pairs";
+                    for (const auto n : results.pentanomial) {
+                        std::cout << " " << n;
+                    }
+                }
+                std::cout << "\n";
             }
 
             // Spacer
@@ -101,7 +142,6 @@
                 std::cout << std::endl;
             }
         } else {
-            const auto is_print_late = results.games_played % settings.ratinginterval == 0;
             const auto is_complete = settings.num_games == results.games_played;
             const auto print_result = is_print_late || is_complete;
 
@@ -168,6 +208,26 @@
     return callbacks;
 }
 
+// Play the games here, share them with nodes on other machines, or play games shared by a coordinator
+[[nodiscard]] auto play_games(const Settings &settings,
+                              const OpeningBook &openings,
+                              Checkpoint checkpoint,
+                              const Callbacks &callbacks) -> Results {
+    switch (settings.distributed.mode) {
+        case DistributedSettings::Mode::Coordinator: {
+            auto coordinator = Coordinator(settings, openings, std::move(checkpoint), callbacks);
+            std::cout << "Waiting for nodes on port " << coordinator.port() << "\n\n";
+            return coordinator.run();
+        }
+        case DistributedSettings::Mode::Node:
+            std::cout << "Playing games for " << settings.distributed.host << ":" << settings.distributed.port
+                      << "\n\n";
+            return run_node(settings, callbacks);
+        default:
+            return run(settings, openings, std::move(checkpoint), callbacks);
+    }
+}
+
 int main(int argc, char **argv) {
     if (argc < 2) {
         std::cerr << "Must provide path to settings file\n";
@@ -175,27 +235,79 @@ int main(int argc, char **argv) {
     }
 
     try {
-        const auto settings = parse::settings(argv[1]);
-        const auto openings = parse::openings(settings.openings_path, settings.shuffle);
+        auto settings = parse::settings(argv[1]);
+
+        // Pondering engines keep searching on their opponent's time, so don't play more games at once than there are
+        // cores for both engines in every game
+        const auto requested_concurrency = settings.concurrency;
+        if (std::any_of(settings.engines.begin(), settings.engines.end(), [](const auto &engine) {
+                return engine.ponder;
+            })) {
+            settings.concurrency = std::min(settings.concurrency, max_concurrency(settings));
+        }
+
+        // Pick up where a previous run stopped
+        auto checkpoint = Checkpoint{};
+        checkpoint.seed = static_cast<std::uint32_t>(std::time(nullptr));
+        auto is_resuming = false;
+        if (settings.recover) {
+            if (auto saved = load_checkpoint(settings.checkpoint.path)) {
+                checkpoint = std::move(*saved);
+                is_resuming = true;
+            }
+        }
+
+        // Nodes are sent the openings along with each game, and leave writing games to the coordinator
+        const auto is_node = settings.distributed.mode == DistributedSettings::Mode::Node;
+
+        const auto openings = is_node ? OpeningBook()
+                                      : parse::openings(settings.openings_path,
+                                                        settings.shuffle,
+                                                        checkpoint.seed,
+                                                        settings.openings_index,
+                                                        settings.openings_unique);
         const auto callbacks = create_callbacks(settings);
 
         // Clear pgn
-        if (settings.pgn.override) {
+        if (settings.pgn.override && !is_resuming && !is_node) {
             std::ofstream file(settings.pgn.path, std::ofstream::trunc);
         }
 
+        // Clear binary games
+        if (settings.binary.override && !is_resuming && !is_node) {
+            std::ofstream file(settings.binary.path, std::ofstream::trunc | std::ofstream::binary);
+        }
+
         std::cout << "Settings:\n";
         std::cout << "- games " << settings.num_games << "\n";
         std::cout << "- engines " << settings.engines.size() << "\n";
-        std::cout << "- concurrency " << settings.concurrency << "\n";
+        std::cout << "- concurrency " << settings.concurrency;
+        if (settings.concurrency < requested_concurrency) {
+            std::cout << " (reduced from " << requested_concurrency << ", pondering games need "
+                      << cores_per_game(settings) << " cores each)";
+        }
+        std::cout << "\n";
+        if (settings.affinity) {
+            std::cout << "- affinity " << cores_per_game(settings) << " cores per game\n";
+        }
         std::cout << "- timecontrol " << settings.tc << "\n";
-        std::cout << "- openings " << openings.size() << "\n";
+        std::cout << "- openings " << openings.size();
+        if (openings.num_duplicates() > 0) {
+            std::cout << " (" << openings.num_duplicates() << " duplicates removed)";
+        }
+        std::cout << "\n";
+        if (is_resuming) {
+            std::cout << "- resuming after " << checkpoint.num_finished() << " games\n";
+        }
         std::cout << "\n";
 
+        // The openings are already loaded, and are shared by every game, so anything on top of this was needed to play
+        const auto memory_before = peak_memory_kb();
+
         // Start timer
         const auto t0 = std::chrono::high_resolution_clock::now();
 
-        const auto results = run(settings, openings, callbacks);
+        const auto results = play_games(settings, openings, checkpoint, callbacks);
 
         // End timer
         const auto t1 = std::chrono::high_resolution_clock::now();
@@ -208,10 +320,15 @@ int main(int argc, char **argv) {
         std::cout << std::setfill('0') << std::setw(2) << hh_mm_ss.hours().count() << "h ";
         std::cout << std::setfill('0') << std::setw(2) << hh_mm_ss.minutes().count() << "m ";
         std::cout << std::setfill('0') << std::setw(2) << hh_mm_ss.seconds().count() << "s\n";
+        // Games restored from the checkpoint weren't played in the time taken
+        const auto games_played = results.games_played - checkpoint.results.games_played;
         std::cout << "Total games: " << results.games_played << "\n";
+        if (is_resuming) {
+            std::cout << "Games this run: " << games_played << "\n";
+        }
         std::cout << "Threads: " << settings.concurrency << "\n";
         if (diff.count() > 0) {
-            const auto games_per_ms = static_cast<float>(results.games_played) / diff.count();
+            const auto games_per_ms = static_cast<float>(games_played) / diff.count();
             const auto games_per_sec = games_per_ms * 1000;
             std::cout << std::setprecision(games_per_sec >= 100 ? 0 : 2);
             std::cout << "games/sec: " << games_per_sec << "\n";
@@ -219,6 +336,51 @@ int main(int argc, char **argv) {
         }
         std::cout << "\n";
 
+        // Print memory usage
+        // These are high-water marks, so the growth includes anything short lived while playing, such as games
+        // waiting to be written or engines starting, and isn't what each game needs for as long as it's played
+        if (const auto memory_after = peak_memory_kb(); memory_after > 0) {
+            std::cout << "Peak memory: " << memory_after / 1024 << "MB\n";
+            std::cout << "Peak memory before playing: " << memory_before / 1024 << "MB\n";
+            std::cout << "Peak memory growth while playing: " << memory_after - memory_before << "KB\n";
+            std::cout << "\n";
+        }
+
+        // Print engine statistics
+        if (results.engines_created > 0) {
+            const auto startup_ms = results.engine_startup_us / results.engines_created / 1000.0f;
+            std::cout << std::setprecision(2);
+            std::cout << "Engines started: " << results.engines_created << "\n";
+            std::cout << "Engines reused: " << results.engines_reused << "\n";
+            std::cout << "Average startup: " << startup_ms << "ms\n";
+            std::cout << "Startup time saved: " << results.engines_reused * startup_ms / 1000.0f << "s\n";
+            std::cout << "\n";
+        }
+
+        // Print move latencies
+        for (const auto &[name, latencies] : results.latencies) {
+            std::cout << "Latency " << name << "\n";
+            std::cout << "  time (ms)          first reply        move\n";
+            for (std::size_t i = 0; i < LatencyHistogram::size; ++i) {
+                const auto first_reply = latencies.first_reply.counts[i];
+                const auto move = latencies.move.counts[i];
+                if (first_reply == 0 && move == 0) {
+                    continue;
+                }
+
+                const auto lower = LatencyHistogram::lower_bound(i) / 1000.0f;
+                const auto upper = LatencyHistogram::lower_bound(i + 1) / 1000.0f;
+                std::cout << std::setfill(' ') << std::fixed << std::setprecision(3) << "  " << std::setw(8) << lower;
+                if (i + 1 < LatencyHistogram::size) {
+                    std::cout << " - " << std::setw(8) << upper;
+                } else {
+                    std::cout << " +         ";
+                }
+                std::cout << std::setw(12) << first_reply << std::setw(12) << move << "\n";
+            }
+            std::cout << "\n";
+        }
+
         // Print match statistics
         std::cout << "Result  Games\n";
         std::cout << "1-0     " << results.black_wins << "\n";
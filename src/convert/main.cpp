@@ -0,0 +1,108 @@
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include "core/binary.hpp"
+#include "core/parse/pgn.hpp"
+#include "core/pgn.hpp"
+
+// Convert between .pgn and .bin game files, the direction is decided by the file extensions
+// Usage: cuteataxx-convert [input] [output]
+
+[[nodiscard]] auto is_binary_path(const std::string &path) -> bool {
+    return path.ends_with(".bin");
+}
+
+auto pgn_to_binary(std::istream &is, std::ostream &os) -> std::size_t {
+    const auto settings = PGNSettings{};
+    std::map<std::string, std::size_t> ids;
+    std::string buffer = binary_header();
+    std::size_t num_games = 0;
+
+    const auto get_id = [&](const std::string &name) -> std::size_t {
+        const auto iter = ids.find(name);
+        if (iter != ids.end()) {
+            return iter->second;
+        }
+        const auto id = ids.size();
+        ids.emplace(name, id);
+        format_binary_engine(buffer, id, name);
+        return id;
+    };
+
+    parse::pgn(is, settings, [&](const parse::PGNGame &game) {
+        const auto id1 = get_id(game.player1);
+        const auto id2 = get_id(game.player2);
+        format_binary_game(buffer, id1, id2, game.game);
+        num_games++;
+
+        if (buffer.size() >= 1 << 20) {
+            os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    });
+
+    os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return num_games;
+}
+
+auto binary_to_pgn(std::istream &is, std::ostream &os) -> std::size_t {
+    auto settings = PGNSettings{};
+    settings.verbose = true;
+    auto reader = BinaryReader(is);
+    auto game = BinaryGame{};
+    std::string buffer;
+    std::size_t num_games = 0;
+
+    while (reader.next(game)) {
+        format_pgn(buffer, settings, reader.engine_name(game.engine1), reader.engine_name(game.engine2), game.game);
+        num_games++;
+
+        if (buffer.size() >= 1 << 20) {
+            os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+
+    os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return num_games;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " [input] [output]\n";
+        std::cerr << "Converts between .pgn and .bin game files\n";
+        return 1;
+    }
+
+    const std::string input = argv[1];
+    const std::string output = argv[2];
+
+    if (is_binary_path(input) == is_binary_path(output)) {
+        std::cerr << "One file must be .bin and the other .pgn\n";
+        return 1;
+    }
+
+    std::ifstream is(input, std::ios::binary);
+    if (!is.is_open()) {
+        std::cerr << "Failed to open " << input << "\n";
+        return 1;
+    }
+
+    std::ofstream os(output, std::ios::binary);
+    if (!os.is_open()) {
+        std::cerr << "Failed to open " << output << "\n";
+        return 1;
+    }
+
+    try {
+        const auto num_games = is_binary_path(input) ? binary_to_pgn(is, os) : pgn_to_binary(is, os);
+        std::cout << "Converted " << num_games << " games\n";
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
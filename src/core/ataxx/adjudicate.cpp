@@ -1,7 +1,12 @@
 #include "adjudicate.hpp"
-#include <iostream>
+#include <cstdint>
 #include <libataxx/bitboard.hpp>
 #include <libataxx/position.hpp>
+#include <optional>
+#include "solve.hpp"
+
+// How hard to try solving a position before giving up until a square is filled
+constexpr std::uint64_t solve_nodes = 10000;
 
 [[nodiscard]] auto can_adjudicate_material(const libataxx::Position &pos, const int threshold) -> bool {
     const auto material_imbalance = pos.get_us().count() - pos.get_them().count();
@@ -9,52 +14,53 @@
 }
 
 [[nodiscard]] auto can_adjudicate_easyfill(const libataxx::Position &pos) -> bool {
-    const auto our_reach = (pos.get_us().singles() | pos.get_us().doubles());
-    const auto them_stuck = our_reach & pos.get_them();
-    const auto them_free = pos.get_them() ^ them_stuck;
-    const auto both_reach = pos.get_both().singles() | pos.get_both().doubles();
+    const auto empty = pos.get_empty();
 
-    // Is the game already over?
-    if (pos.is_gameover()) {
+    // Can we still move?
+    // This rules out almost every position, so it's checked before anything else is worked out,
+    // starting with single moves since they're cheaper to find and more likely
+    if (pos.get_us().singles() & empty) {
         return false;
     }
 
-    // Can we still move?
-    if (our_reach & pos.get_empty()) {
+    const auto our_reach = pos.get_us().singles() | pos.get_us().doubles();
+    if (our_reach & empty) {
         return false;
     }
 
     // Can they move without releasing us?
-    if (!((pos.get_them().singles() | them_free.doubles()) & pos.get_empty())) {
+    const auto them_stuck = our_reach & pos.get_them();
+    const auto them_free = pos.get_them() ^ them_stuck;
+    const auto their_moves = (pos.get_them().singles() | them_free.doubles()) & empty;
+    if (!their_moves) {
+        return false;
+    }
+
+    // Is the game already over?
+    if (pos.is_gameover()) {
         return false;
     }
 
     // Pretend they get everything, is it enough?
-    if (pos.get_us().count() > pos.get_them().count() + pos.get_empty().count()) {
+    if (pos.get_us().count() > pos.get_them().count() + empty.count()) {
         return false;
     }
 
-    const auto reachable = [&] {
-        auto bb = (pos.get_them().singles() | them_free.doubles()) & pos.get_empty();
-        bb |= (bb.singles() | bb.doubles()) & pos.get_empty();
-        bb |= (bb.singles() | bb.doubles()) & pos.get_empty();
-        bb |= (bb.singles() | bb.doubles()) & pos.get_empty();
-        bb |= (bb.singles() | bb.doubles()) & pos.get_empty();
-        bb |= (bb.singles() | bb.doubles()) & pos.get_empty();
-        bb |= (bb.singles() | bb.doubles()) & pos.get_empty();
-        bb |= (bb.singles() | bb.doubles()) & pos.get_empty();
-        bb |= (bb.singles() | bb.doubles()) & pos.get_empty();
-        bb |= (bb.singles() | bb.doubles()) & pos.get_empty();
-        bb |= (bb.singles() | bb.doubles()) & pos.get_empty();
-        return bb;
-    }();
-
-    const auto reservoirs = (pos.get_empty() | pos.get_them()).singles() & (pos.get_empty() | pos.get_them());
+    // Spread out from their moves until there's nowhere new to reach
+    auto reachable = their_moves;
+    auto frontier = their_moves;
+    while (frontier) {
+        const auto next = (frontier.singles() | frontier.doubles()) & empty;
+        frontier = next ^ (next & reachable);
+        reachable |= frontier;
+    }
+
+    const auto reservoirs = (empty | pos.get_them()).singles() & (empty | pos.get_them());
     if (!(reachable & reservoirs)) {
         return false;
     }
 
-    if ((reachable & reservoirs) && pos.get_them().count() + reachable.count() < pos.get_us().count()) {
+    if (pos.get_them().count() + reachable.count() < pos.get_us().count()) {
         return false;
     }
 
@@ -64,3 +70,52 @@
 [[nodiscard]] auto can_adjudicate_gamelength(const libataxx::Position &pos, const int limit) -> bool {
     return pos.get_fullmoves() >= limit;
 }
+
+[[nodiscard]] auto adjudicate(const libataxx::Position &pos,
+                              const AdjudicationSettings &settings,
+                              AdjudicationState &state) -> std::optional<Adjudication> {
+    // Try to adjudicate based on material imbalance
+    if (settings.material && can_adjudicate_material(pos, *settings.material)) {
+        return Adjudication{pos.get_turn() == libataxx::Side::Black ? libataxx::Result::BlackWin
+                                                                    : libataxx::Result::WhiteWin,
+                            ResultReason::MaterialImbalance};
+    }
+
+    // Try to adjudicate based on "easy fill"
+    // This is when one side has to pass and the other can fill the rest of the board trivially to win
+    if (settings.easyfill && *settings.easyfill && can_adjudicate_easyfill(pos)) {
+        return Adjudication{pos.get_turn() == libataxx::Side::Black ? libataxx::Result::WhiteWin
+                                                                    : libataxx::Result::BlackWin,
+                            ResultReason::EasyFill};
+    }
+
+    // Try to adjudicate based on game length
+    if (settings.gamelength && can_adjudicate_gamelength(pos, *settings.gamelength)) {
+        return Adjudication{libataxx::Result::Draw, ResultReason::Gamelength};
+    }
+
+    // Try to adjudicate by working out the result, once there are few enough empty squares for it to be quick
+    // Only filling squares makes a position much easier, so one that couldn't be solved isn't tried again until then
+    const int empties = pos.get_empty().count();
+    const auto is_new = !state.unsolved_empties || empties < *state.unsolved_empties;
+    if (settings.solve && empties <= *settings.solve && is_new) {
+        // The game is drawn on length once it gets there, so the result has to come sooner
+        auto plies_left = std::optional<int>();
+        if (settings.gamelength) {
+            plies_left = 2 * (*settings.gamelength - pos.get_fullmoves()) - (pos.get_turn() == libataxx::Side::White);
+        }
+
+        if (const auto result = solve(pos, solve_nodes, plies_left)) {
+            return Adjudication{*result, ResultReason::Solved};
+        }
+        state.unsolved_empties = empties;
+    }
+
+    return std::nullopt;
+}
+
+[[nodiscard]] auto adjudicate(const libataxx::Position &pos, const AdjudicationSettings &settings)
+    -> std::optional<Adjudication> {
+    auto state = AdjudicationState{};
+    return adjudicate(pos, settings, state);
+}
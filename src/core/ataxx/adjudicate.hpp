@@ -1,12 +1,32 @@
 #ifndef ATAXX_ADJUDICATE_HPP
 #define ATAXX_ADJUDICATE_HPP
 
-namespace libataxx {
-class Position;
-}  // namespace libataxx
+#include <libataxx/position.hpp>
+#include <optional>
+#include "../play.hpp"
+
+struct Adjudication {
+    libataxx::Result result = libataxx::Result::None;
+    ResultReason reason = ResultReason::None;
+};
+
+// What adjudication has already tried during a game, so it isn't repeated before every move
+struct AdjudicationState {
+    // The solver gave up with this many empty squares, so it waits for fewer before trying again
+    std::optional<int> unsolved_empties;
+};
 
 [[nodiscard]] auto can_adjudicate_material(const libataxx::Position &pos, const int threshold) -> bool;
 [[nodiscard]] auto can_adjudicate_easyfill(const libataxx::Position &pos) -> bool;
 [[nodiscard]] auto can_adjudicate_gamelength(const libataxx::Position &pos, const int limit) -> bool;
 
+// Whether a game that isn't over yet can be ended early, checked before every move
+[[nodiscard]] auto adjudicate(const libataxx::Position &pos,
+                              const AdjudicationSettings &settings,
+                              AdjudicationState &state) -> std::optional<Adjudication>;
+
+// The same for a position on its own, outside of a game
+[[nodiscard]] auto adjudicate(const libataxx::Position &pos, const AdjudicationSettings &settings)
+    -> std::optional<Adjudication>;
+
 #endif
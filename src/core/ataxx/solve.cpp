@@ -0,0 +1,216 @@
+#include "solve.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <libataxx/move.hpp>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Scores are from the point of view of the side to move
+constexpr int win = 1;
+constexpr int draw = 0;
+constexpr int loss = -1;
+
+// 2^16 entries of 16 bytes, per thread
+constexpr std::size_t table_size = 1 << 16;
+
+// The fifty move rule ends every game within this many plies of a single move or capture
+constexpr int max_depth = 100;
+
+enum class Bound : std::uint8_t
+{
+    None = 0,
+    Exact,
+    Lower,
+    Upper,
+};
+
+// Which way a score was guessed at the depth limit, if it was guessed at all
+enum class Horizon : std::uint8_t
+{
+    None = 0,
+    Win,
+    Loss,
+};
+
+struct TTEntry {
+    std::uint64_t key = 0;
+    std::int8_t score = 0;
+    Bound bound = Bound::None;
+    Horizon horizon = Horizon::None;
+    std::uint8_t depth = 0;
+};
+
+// Positions with few empty squares can still go on for a long time, with both sides moving pieces around with doubles
+// instead of filling squares, so a plain search to the end of the game rarely finishes
+// Instead, search deeper and deeper, each time counting positions past the depth limit first as losses and then as
+// wins for the side we're solving for. The first gives a score we're sure of getting, the second one we can't beat,
+// and once they agree that's the result
+class Solver {
+   public:
+    [[nodiscard]] Solver() : m_table(table_size) {
+    }
+
+    [[nodiscard]] auto solve(const libataxx::Position &pos, const std::uint64_t max_nodes, const int max_plies)
+        -> std::optional<int> {
+        m_nodes = 0;
+        m_max_nodes = max_nodes;
+        m_stopped = false;
+
+        const auto us = pos.get_turn();
+        const auto them = us == libataxx::Side::Black ? libataxx::Side::White : libataxx::Side::Black;
+
+        for (int depth = 1; depth <= std::min(max_depth, max_plies); ++depth) {
+            m_reached_horizon = false;
+            const auto lower = search(pos, loss, win, depth, them);
+            if (m_stopped) {
+                return std::nullopt;
+            } else if (!m_reached_horizon || lower == win) {
+                return lower;
+            }
+
+            const auto upper = search(pos, loss, win, depth, us);
+            if (m_stopped) {
+                return std::nullopt;
+            } else if (upper == lower) {
+                return lower;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+   private:
+    // The fifty move rule means the same position can have a different result depending on the halfmove clock
+    [[nodiscard]] static auto key(const libataxx::Position &pos) -> std::uint64_t {
+        return pos.get_hash() ^ (static_cast<std::uint64_t>(pos.get_halfmoves()) * 0x9E3779B97F4A7C15ULL);
+    }
+
+    [[nodiscard]] static auto terminal_score(const libataxx::Position &pos) -> int {
+        switch (pos.get_result()) {
+            case libataxx::Result::BlackWin:
+                return pos.get_turn() == libataxx::Side::Black ? win : loss;
+            case libataxx::Result::WhiteWin:
+                return pos.get_turn() == libataxx::Side::White ? win : loss;
+            default:
+                return draw;
+        }
+    }
+
+    // Captures first, then singles since they fill a square
+    [[nodiscard]] static auto ordered_moves(const libataxx::Position &pos) -> std::vector<libataxx::Move> {
+        auto moves = pos.legal_moves();
+        std::vector<std::pair<int, libataxx::Move>> scored;
+        scored.reserve(moves.size());
+
+        for (const auto &move : moves) {
+            const auto score = move == libataxx::Move::nullmove() ? 0 : 2 * pos.count_captures(move) + move.is_single();
+            scored.emplace_back(score, move);
+        }
+
+        std::stable_sort(scored.begin(), scored.end(), [](const auto &a, const auto &b) {
+            return a.first > b.first;
+        });
+
+        for (std::size_t i = 0; i < scored.size(); ++i) {
+            moves[i] = scored[i].second;
+        }
+
+        return moves;
+    }
+
+    // Positions past the depth limit are wins for the favoured side
+    [[nodiscard]] auto search(const libataxx::Position &pos,
+                              int alpha,
+                              const int beta,
+                              const int depth,
+                              const libataxx::Side favoured) -> int {
+        if (pos.is_gameover()) {
+            return terminal_score(pos);
+        }
+
+        if (depth <= 0) {
+            m_reached_horizon = true;
+            return pos.get_turn() == favoured ? win : loss;
+        }
+
+        if (++m_nodes > m_max_nodes) {
+            m_stopped = true;
+            return draw;
+        }
+
+        // Scores that didn't depend on the depth limit hold for every search that has as many moves left to play them
+        // out, the rest only for those that guess the same way and search at least as deep
+        const auto horizon = pos.get_turn() == favoured ? Horizon::Win : Horizon::Loss;
+        const auto k = key(pos);
+        const auto &entry = m_table[k % m_table.size()];
+        const auto is_usable = entry.horizon == Horizon::None ? entry.depth <= depth
+                                                              : entry.horizon == horizon && entry.depth >= depth;
+        if (entry.key == k && is_usable) {
+            if (entry.bound == Bound::Exact || (entry.bound == Bound::Lower && entry.score >= beta) ||
+                (entry.bound == Bound::Upper && entry.score <= alpha)) {
+                m_reached_horizon = m_reached_horizon || entry.horizon != Horizon::None;
+                return entry.score;
+            }
+        }
+
+        const auto alpha_original = alpha;
+        const auto reached_horizon = m_reached_horizon;
+        m_reached_horizon = false;
+        auto best = loss;
+
+        for (const auto &move : ordered_moves(pos)) {
+            auto npos = pos;
+            npos.makemove(move);
+            const auto score = -search(npos, -beta, -alpha, depth - 1, favoured);
+
+            if (m_stopped) {
+                return draw;
+            }
+
+            best = std::max(best, score);
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) {
+                break;
+            }
+        }
+
+        // Only results that were searched to the end are kept
+        const auto bound = best >= beta ? Bound::Lower : best > alpha_original ? Bound::Exact : Bound::Upper;
+        m_table[k % m_table.size()] = TTEntry{k,
+                                              static_cast<std::int8_t>(best),
+                                              bound,
+                                              m_reached_horizon ? horizon : Horizon::None,
+                                              static_cast<std::uint8_t>(depth)};
+        m_reached_horizon = m_reached_horizon || reached_horizon;
+
+        return best;
+    }
+
+    std::vector<TTEntry> m_table;
+    std::uint64_t m_nodes = 0;
+    std::uint64_t m_max_nodes = 0;
+    // Whether the current search guessed any scores
+    bool m_reached_horizon = false;
+    bool m_stopped = false;
+};
+
+}  // namespace
+
+[[nodiscard]] auto solve(const libataxx::Position &pos,
+                         const std::uint64_t max_nodes,
+                         const std::optional<int> max_plies) -> std::optional<libataxx::Result> {
+    // Every thread plays its own games, so each gets a solver of its own
+    thread_local Solver solver;
+
+    const auto score = solver.solve(pos, max_nodes, max_plies.value_or(max_depth));
+    if (!score) {
+        return std::nullopt;
+    } else if (*score == draw) {
+        return libataxx::Result::Draw;
+    }
+
+    const auto is_black_win = (*score == win) == (pos.get_turn() == libataxx::Side::Black);
+    return is_black_win ? libataxx::Result::BlackWin : libataxx::Result::WhiteWin;
+}
@@ -0,0 +1,15 @@
+#ifndef ATAXX_SOLVE_HPP
+#define ATAXX_SOLVE_HPP
+
+#include <cstdint>
+#include <libataxx/position.hpp>
+#include <optional>
+
+// The result of a position with perfect play from both sides, if it can be proven within the node limit
+// With a ply limit, the result is only given if the game is sure to end within that many moves
+// Proven positions are kept in a hash table belonging to the calling thread, so they're free to look up next time
+[[nodiscard]] auto solve(const libataxx::Position &pos,
+                         const std::uint64_t max_nodes,
+                         const std::optional<int> max_plies = std::nullopt) -> std::optional<libataxx::Result>;
+
+#endif
@@ -0,0 +1,87 @@
+#include "symmetry.hpp"
+#include <algorithm>
+#include <array>
+#include <libataxx/bitboard.hpp>
+#include <utility>
+
+namespace {
+
+constexpr int num_symmetries = 8;
+
+// Where each rank of the board ends up under each symmetry, for every way the rank could be filled
+// Transforming a board is then one lookup per rank
+using SymmetryTable = std::array<std::array<std::array<std::uint64_t, 128>, 7>, num_symmetries>;
+
+[[nodiscard]] constexpr auto transform_square(const int symmetry, int file, int rank) noexcept -> int {
+    if (symmetry & 1) {
+        file = 6 - file;
+    }
+    if (symmetry & 2) {
+        rank = 6 - rank;
+    }
+    if (symmetry & 4) {
+        std::swap(file, rank);
+    }
+    return rank * 7 + file;
+}
+
+[[nodiscard]] constexpr auto make_table() noexcept -> SymmetryTable {
+    SymmetryTable table{};
+    for (int symmetry = 0; symmetry < num_symmetries; ++symmetry) {
+        for (int rank = 0; rank < 7; ++rank) {
+            for (int row = 0; row < 128; ++row) {
+                for (int file = 0; file < 7; ++file) {
+                    if (row & (1 << file)) {
+                        table[symmetry][rank][row] |= std::uint64_t{1} << transform_square(symmetry, file, rank);
+                    }
+                }
+            }
+        }
+    }
+    return table;
+}
+
+constexpr SymmetryTable symmetry_table = make_table();
+
+// One bit per square, a1 first
+[[nodiscard]] auto to_bits(const libataxx::Bitboard &bb) noexcept -> std::uint64_t {
+    std::uint64_t bits = 0;
+    for (const auto sq : bb) {
+        bits |= std::uint64_t{1} << (sq.rank() * 7 + sq.file());
+    }
+    return bits;
+}
+
+[[nodiscard]] auto transform(const int symmetry, const std::uint64_t bits) noexcept -> std::uint64_t {
+    std::uint64_t result = 0;
+    for (int rank = 0; rank < 7; ++rank) {
+        result |= symmetry_table[symmetry][rank][(bits >> (7 * rank)) & 127];
+    }
+    return result;
+}
+
+[[nodiscard]] constexpr auto mix(std::uint64_t n) noexcept -> std::uint64_t {
+    n ^= n >> 33;
+    n *= 0xFF51AFD7ED558CCDULL;
+    n ^= n >> 33;
+    n *= 0xC4CEB9FE1A85EC53ULL;
+    n ^= n >> 33;
+    return n;
+}
+
+}  // namespace
+
+[[nodiscard]] auto canonical_hash(const libataxx::Position &pos) noexcept -> std::uint64_t {
+    // Going by the side to move rather than by colour makes swapping colours free
+    const auto us = to_bits(pos.get_us());
+    const auto them = to_bits(pos.get_them());
+    const auto gaps = to_bits(pos.get_gaps());
+
+    auto hash = ~std::uint64_t{0};
+    for (int symmetry = 0; symmetry < num_symmetries; ++symmetry) {
+        const auto h = mix(transform(symmetry, us)) ^ mix(transform(symmetry, them) + 0x9E3779B97F4A7C15ULL) ^
+                       mix(transform(symmetry, gaps) + 0x3C6EF372FE94F82AULL);
+        hash = std::min(hash, h);
+    }
+    return hash;
+}
@@ -0,0 +1,11 @@
+#ifndef ATAXX_SYMMETRY_HPP
+#define ATAXX_SYMMETRY_HPP
+
+#include <cstdint>
+#include <libataxx/position.hpp>
+
+// The same for every position that's the same as this one after rotating or reflecting the board, or swapping colours
+// Only the pieces, gaps and side to move count, not the move counters
+[[nodiscard]] auto canonical_hash(const libataxx::Position &pos) noexcept -> std::uint64_t;
+
+#endif
@@ -0,0 +1,252 @@
+#include "binary.hpp"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+
+constexpr std::string_view magic = "CAXB";
+constexpr std::uint8_t version = 1;
+constexpr std::uint16_t pass_move = 0xFFFF;
+constexpr std::uint16_t double_flag = 1 << 12;
+
+auto append_byte(std::string &out, const std::uint8_t n) -> void {
+    out += static_cast<char>(n);
+}
+
+auto append_varint(std::string &out, std::uint64_t n) -> void {
+    while (n >= 0x80) {
+        append_byte(out, static_cast<std::uint8_t>(n | 0x80));
+        n >>= 7;
+    }
+    append_byte(out, static_cast<std::uint8_t>(n));
+}
+
+[[nodiscard]] auto square_index(const libataxx::Square sq) -> int {
+    return sq.rank() * 7 + sq.file();
+}
+
+[[nodiscard]] auto encode_move(const libataxx::Move &move) -> std::uint16_t {
+    if (move == libataxx::Move::nullmove()) {
+        return pass_move;
+    } else if (move.is_single()) {
+        return static_cast<std::uint16_t>(square_index(move.to()));
+    } else {
+        return static_cast<std::uint16_t>(double_flag | square_index(move.from()) << 6 | square_index(move.to()));
+    }
+}
+
+[[nodiscard]] auto decode_move(const std::uint16_t n) -> libataxx::Move {
+    const auto from = libataxx::Square((n >> 6) & 0x3F);
+    const auto to = libataxx::Square(n & 0x3F);
+
+    if (n == pass_move) {
+        return libataxx::Move::nullmove();
+    } else if (n & double_flag) {
+        return libataxx::Move(from, to);
+    } else {
+        return libataxx::Move(to);
+    }
+}
+
+// Two bits per square, 0 empty, 1 black, 2 white, 3 gap
+auto append_board(std::string &out, const libataxx::Position &pos) -> void {
+    std::array<std::uint8_t, 13> packed = {};
+
+    for (int i = 0; i < 49; ++i) {
+        const auto sq = libataxx::Square(i);
+        auto n = 0;
+        if (pos.get_black().get(sq)) {
+            n = 1;
+        } else if (pos.get_white().get(sq)) {
+            n = 2;
+        } else if (pos.get_gaps().get(sq)) {
+            n = 3;
+        }
+        packed[i / 4] |= static_cast<std::uint8_t>(n << (2 * (i % 4)));
+    }
+
+    for (const auto n : packed) {
+        append_byte(out, n);
+    }
+}
+
+[[nodiscard]] auto board_fen(const std::array<std::uint8_t, 13> &packed) -> std::string {
+    std::string fen;
+
+    for (int r = 6; r >= 0; --r) {
+        auto num_empty = 0;
+
+        for (int f = 0; f < 7; ++f) {
+            const auto i = r * 7 + f;
+            const auto n = (packed[i / 4] >> (2 * (i % 4))) & 3;
+
+            if (n == 0) {
+                num_empty++;
+                continue;
+            }
+
+            if (num_empty > 0) {
+                fen += static_cast<char>('0' + num_empty);
+                num_empty = 0;
+            }
+
+            fen += n == 1 ? 'x' : n == 2 ? 'o' : '-';
+        }
+
+        if (num_empty > 0) {
+            fen += static_cast<char>('0' + num_empty);
+        }
+
+        if (r > 0) {
+            fen += '/';
+        }
+    }
+
+    return fen;
+}
+
+}  // namespace
+
+auto binary_header() -> std::string {
+    std::string out(magic);
+    append_byte(out, version);
+    return out;
+}
+
+auto format_binary_engine(std::string &out, const std::size_t id, const std::string &name) -> void {
+    out += 'E';
+    append_varint(out, id);
+    append_varint(out, name.size());
+    out += name;
+}
+
+auto format_binary_game(std::string &out, const std::size_t engine1, const std::size_t engine2, const GameThingy &data)
+    -> void {
+    out += 'G';
+    append_board(out, data.startpos);
+    append_byte(out, data.startpos.get_turn() == libataxx::Side::Black ? 0 : 1);
+    append_varint(out, static_cast<std::uint64_t>(data.startpos.get_halfmoves()));
+    append_varint(out, static_cast<std::uint64_t>(data.startpos.get_fullmoves()));
+    append_varint(out, engine1);
+    append_varint(out, engine2);
+    append_byte(out, static_cast<std::uint8_t>(data.result));
+    append_byte(out, static_cast<std::uint8_t>(data.reason));
+    append_varint(out, data.history.size());
+
+    for (const auto &info : data.history) {
+        const auto n = encode_move(info.move);
+        append_byte(out, static_cast<std::uint8_t>(n & 0xFF));
+        append_byte(out, static_cast<std::uint8_t>(n >> 8));
+    }
+
+    for (const auto &info : data.history) {
+        append_varint(out, static_cast<std::uint64_t>(std::max(info.movetime, 0)));
+    }
+}
+
+BinaryReader::BinaryReader(std::istream &is) : m_is(is), m_buffer(1 << 16) {
+    for (const auto c : magic) {
+        if (is_eof() || get() != static_cast<std::uint8_t>(c)) {
+            throw std::invalid_argument("Not a binary game file");
+        }
+    }
+
+    if (is_eof() || get() != version) {
+        throw std::invalid_argument("Unsupported binary game file version");
+    }
+}
+
+auto BinaryReader::next(BinaryGame &game) -> bool {
+    while (!is_eof()) {
+        const auto tag = get();
+
+        if (tag == 'E') {
+            const auto id = get_varint();
+            const auto length = get_varint();
+            std::string name;
+            for (std::uint64_t i = 0; i < length; ++i) {
+                name += static_cast<char>(get());
+            }
+            if (id >= m_engines.size()) {
+                m_engines.resize(id + 1);
+            }
+            m_engines[id] = name;
+        } else if (tag == 'G') {
+            std::array<std::uint8_t, 13> packed;
+            for (auto &n : packed) {
+                n = get();
+            }
+
+            const auto turn = get();
+            const auto halfmoves = get_varint();
+            const auto fullmoves = get_varint();
+            const auto fen = board_fen(packed) + (turn == 0 ? " x " : " o ") + std::to_string(halfmoves) + " " +
+                             std::to_string(fullmoves);
+
+            game.engine1 = get_varint();
+            game.engine2 = get_varint();
+            game.game.result = static_cast<libataxx::Result>(get());
+            game.game.reason = static_cast<ResultReason>(get());
+            game.game.startpos = libataxx::Position(fen);
+            game.game.endpos = game.game.startpos;
+            game.game.history.resize(get_varint());
+
+            for (auto &info : game.game.history) {
+                const auto lo = get();
+                const auto hi = get();
+                info = MoveThingy{};
+                info.move = decode_move(static_cast<std::uint16_t>(lo | hi << 8));
+                game.game.endpos.makemove(info.move);
+            }
+
+            for (auto &info : game.game.history) {
+                info.movetime = static_cast<int>(get_varint());
+            }
+
+            return true;
+        } else {
+            throw std::invalid_argument("Unknown record in binary game file");
+        }
+    }
+
+    return false;
+}
+
+auto BinaryReader::engine_name(const std::size_t id) const -> std::string {
+    if (id < m_engines.size()) {
+        return m_engines[id];
+    }
+    return std::to_string(id);
+}
+
+auto BinaryReader::get() -> std::uint8_t {
+    if (is_eof()) {
+        throw std::invalid_argument("Unexpected end of binary game file");
+    }
+    return static_cast<std::uint8_t>(m_buffer[m_pos++]);
+}
+
+auto BinaryReader::get_varint() -> std::uint64_t {
+    std::uint64_t n = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const auto byte = get();
+        n |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return n;
+        }
+    }
+    throw std::invalid_argument("Bad varint in binary game file");
+}
+
+auto BinaryReader::is_eof() -> bool {
+    if (m_pos < m_end) {
+        return false;
+    }
+
+    m_is.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_pos = 0;
+    m_end = static_cast<std::size_t>(m_is.gcount());
+    return m_end == 0;
+}
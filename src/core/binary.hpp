@@ -0,0 +1,74 @@
+#ifndef BINARY_HPP
+#define BINARY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+#include "play.hpp"
+
+// Games stored in a compact binary format
+//
+// The file starts with the magic bytes "CAXB" and a version byte, followed by any number of records
+// Each record starts with a tag byte:
+// 'E' engine name: varint id, varint length, name
+// 'G' game:
+//     13 bytes for the start position, two bits per square starting from a1 (0 empty, 1 black, 2 white, 3 gap)
+//     1 byte side to move (0 black, 1 white), varint halfmove clock, varint fullmove number
+//     varint black engine id, varint white engine id
+//     1 byte result, 1 byte adjudication reason
+//     varint number of moves, then 2 bytes per move, then a varint movetime per move
+//
+// Moves are little endian, 0xFFFF is a pass, otherwise bits 0-5 are the destination square index,
+// bits 6-11 the source square index, and bit 12 is set for double moves
+// Engine records can appear more than once, such as when several matches write to the same file,
+// and apply to the games that come after them
+
+struct BinarySettings {
+    std::string path = "games.bin";
+    bool enabled = false;
+    bool override = false;
+};
+
+struct BinaryGame {
+    std::size_t engine1 = 0;
+    std::size_t engine2 = 0;
+    GameThingy game;
+};
+
+[[nodiscard]] auto binary_header() -> std::string;
+
+// Append an engine record to the end of the string
+auto format_binary_engine(std::string &out, const std::size_t id, const std::string &name) -> void;
+
+// Append a game record to the end of the string
+auto format_binary_game(std::string &out, const std::size_t engine1, const std::size_t engine2, const GameThingy &data)
+    -> void;
+
+class BinaryReader {
+   public:
+    // Throws if the stream doesn't start with a valid header
+    [[nodiscard]] explicit BinaryReader(std::istream &is);
+
+    // Read the next game, reusing the storage already in the game given
+    // Returns false once there are no more games
+    [[nodiscard]] auto next(BinaryGame &game) -> bool;
+
+    [[nodiscard]] auto engine_name(const std::size_t id) const -> std::string;
+
+   private:
+    [[nodiscard]] auto get() -> std::uint8_t;
+
+    [[nodiscard]] auto get_varint() -> std::uint64_t;
+
+    [[nodiscard]] auto is_eof() -> bool;
+
+    std::istream &m_is;
+    std::vector<char> m_buffer;
+    std::size_t m_pos = 0;
+    std::size_t m_end = 0;
+    std::vector<std::string> m_engines;
+};
+
+#endif
@@ -0,0 +1,323 @@
+#ifndef BUILTIN_ALPHABETA_HPP
+#define BUILTIN_ALPHABETA_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <libataxx/move.hpp>
+#include <libataxx/position.hpp>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "builtin.hpp"
+
+// An iterative deepening alpha-beta search on material, with a transposition table
+// Much stronger than the other builtins, for calibrating engines without the cost of running another process
+// Honours every kind of search limit, and the size of its hash table can be set with the "hash" option in megabytes
+class AlphaBetaBuiltin final : public BuiltinEngine {
+   public:
+    [[nodiscard]] AlphaBetaBuiltin(std::function<void(const std::string &msg)> send = {},
+                                   std::function<void(const std::string &msg)> recv = {})
+        : BuiltinEngine(send, recv) {
+        resize(default_hash_mb);
+    }
+
+    virtual auto newgame() -> void override {
+        std::fill(m_table.begin(), m_table.end(), TTEntry{});
+    }
+
+    virtual auto set_option(const std::string &name, const std::string &value) -> void override {
+        auto lower = name;
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) {
+            return std::tolower(c);
+        });
+
+        if (lower == "hash") {
+            resize(std::max(1, std::stoi(value)));
+        }
+    }
+
+    [[nodiscard]] virtual auto search(const libataxx::Position &pos,
+                                      const SearchSettings &settings) -> libataxx::Move override {
+        if (pos.is_gameover()) {
+            return libataxx::Move::nullmove();
+        }
+
+        start(pos, settings);
+
+        const auto max_depth = settings.type == SearchSettings::Type::Depth ? std::max(1, settings.ply) : max_ply;
+        auto best_move = libataxx::Move::nomove();
+
+        for (int depth = 1; depth <= max_depth; ++depth) {
+            const auto move = search_root(pos, depth);
+
+            // Moves from a search that was cut short are only used if there's nothing better
+            if (m_stopped) {
+                if (best_move == libataxx::Move::nomove()) {
+                    best_move = move;
+                }
+                break;
+            }
+
+            best_move = move;
+
+            // Another iteration takes longer than all the ones before it, so don't start one we can't finish
+            if (m_soft_deadline && std::chrono::steady_clock::now() >= *m_soft_deadline) {
+                break;
+            }
+        }
+
+        return best_move;
+    }
+
+   private:
+    static constexpr int default_hash_mb = 8;
+    static constexpr int max_ply = 64;
+    static constexpr int mate_score = 30000;
+    static constexpr int mate_bound = mate_score - max_ply;
+    static constexpr int infinity = mate_score + 1;
+
+    // How often to look at the clock, in nodes
+    static constexpr std::uint64_t check_interval = 256;
+
+    enum class Bound : std::uint8_t
+    {
+        None = 0,
+        Exact,
+        Lower,
+        Upper,
+    };
+
+    struct TTEntry {
+        std::uint64_t hash = 0;
+        libataxx::Move move = libataxx::Move::nomove();
+        int score = 0;
+        int depth = 0;
+        Bound bound = Bound::None;
+    };
+
+    auto resize(const int megabytes) -> void {
+        const auto entries = static_cast<std::size_t>(megabytes) * 1024 * 1024 / sizeof(TTEntry);
+        m_table.assign(std::max<std::size_t>(entries, 1), TTEntry{});
+    }
+
+    // Work out when to stop searching from the limits given
+    auto start(const libataxx::Position &pos, const SearchSettings &settings) -> void {
+        const auto now = std::chrono::steady_clock::now();
+
+        m_nodes = 0;
+        m_next_check = check_interval;
+        m_stopped = false;
+        m_max_nodes.reset();
+        m_deadline.reset();
+        m_soft_deadline.reset();
+
+        switch (settings.type) {
+            case SearchSettings::Type::Nodes:
+                m_max_nodes = std::max(1, settings.nodes);
+                break;
+            case SearchSettings::Type::Movetime:
+                m_deadline = now + std::chrono::milliseconds(settings.movetime);
+                break;
+            case SearchSettings::Type::Time: {
+                const auto is_black = pos.get_turn() == libataxx::Side::Black;
+                const auto remaining = is_black ? settings.btime : settings.wtime;
+                const auto increment = is_black ? settings.binc : settings.winc;
+                const auto moves_left = settings.movestogo > 0 ? settings.movestogo : 30;
+                const auto budget = std::max(1, std::min(remaining / moves_left + increment / 2, remaining / 2));
+                m_deadline = now + std::chrono::milliseconds(budget);
+                m_soft_deadline = now + std::chrono::milliseconds(budget / 2);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    [[nodiscard]] auto should_stop() -> bool {
+        if (m_stopped) {
+            return true;
+        }
+
+        if (m_max_nodes && m_nodes >= static_cast<std::uint64_t>(*m_max_nodes)) {
+            m_stopped = true;
+        } else if (m_nodes >= m_next_check) {
+            m_next_check = m_nodes + check_interval;
+            m_stopped = (m_deadline && std::chrono::steady_clock::now() >= *m_deadline) ||
+                        (m_interrupt && m_interrupt->load(std::memory_order_relaxed));
+        }
+
+        return m_stopped;
+    }
+
+    // Captures first, then singles since they gain a piece
+    [[nodiscard]] static auto ordered_moves(const libataxx::Position &pos, const libataxx::Move tt_move)
+        -> std::vector<libataxx::Move> {
+        auto moves = pos.legal_moves();
+        std::vector<std::pair<int, libataxx::Move>> scored;
+        scored.reserve(moves.size());
+
+        for (const auto &move : moves) {
+            const auto score = move == tt_move                  ? 1000
+                               : move == libataxx::Move::nullmove() ? 0
+                                                                    : 2 * pos.count_captures(move) + move.is_single();
+            scored.emplace_back(score, move);
+        }
+
+        std::stable_sort(scored.begin(), scored.end(), [](const auto &a, const auto &b) {
+            return a.first > b.first;
+        });
+
+        for (std::size_t i = 0; i < scored.size(); ++i) {
+            moves[i] = scored[i].second;
+        }
+
+        return moves;
+    }
+
+    // From the side to move's point of view
+    [[nodiscard]] static auto eval(const libataxx::Position &pos) -> int {
+        return pos.get_us().count() - pos.get_them().count();
+    }
+
+    [[nodiscard]] static auto terminal_score(const libataxx::Position &pos, const int ply) -> int {
+        switch (pos.get_result()) {
+            case libataxx::Result::BlackWin:
+                return pos.get_turn() == libataxx::Side::Black ? mate_score - ply : -mate_score + ply;
+            case libataxx::Result::WhiteWin:
+                return pos.get_turn() == libataxx::Side::White ? mate_score - ply : -mate_score + ply;
+            default:
+                return 0;
+        }
+    }
+
+    // Wins are stored relative to the position rather than the root, so they can be found from anywhere
+    [[nodiscard]] static auto to_tt(const int score, const int ply) -> int {
+        return score > mate_bound ? score + ply : score < -mate_bound ? score - ply : score;
+    }
+
+    [[nodiscard]] static auto from_tt(const int score, const int ply) -> int {
+        return score > mate_bound ? score - ply : score < -mate_bound ? score + ply : score;
+    }
+
+    [[nodiscard]] auto search_root(const libataxx::Position &pos, const int depth) -> libataxx::Move {
+        const auto &entry = m_table[pos.get_hash() % m_table.size()];
+        const auto tt_move = entry.hash == pos.get_hash() ? entry.move : libataxx::Move::nomove();
+        const auto moves = ordered_moves(pos, tt_move);
+
+        auto alpha = -infinity;
+        auto best_move = moves.front();
+
+        for (const auto &move : moves) {
+            auto npos = pos;
+            npos.makemove(move);
+            const auto score = -negamax(npos, -infinity, -alpha, depth - 1, 1);
+
+            if (m_stopped) {
+                break;
+            }
+
+            if (score > alpha) {
+                alpha = score;
+                best_move = move;
+            }
+        }
+
+        if (!m_stopped) {
+            store(pos.get_hash(), best_move, alpha, depth, Bound::Exact, 0);
+        }
+
+        return best_move;
+    }
+
+    [[nodiscard]] auto negamax(const libataxx::Position &pos, int alpha, const int beta, const int depth, const int ply)
+        -> int {
+        ++m_nodes;
+
+        if (pos.is_gameover()) {
+            return terminal_score(pos, ply);
+        }
+
+        if (depth <= 0 || ply >= max_ply) {
+            return eval(pos);
+        }
+
+        if (should_stop()) {
+            return 0;
+        }
+
+        const auto hash = pos.get_hash();
+        const auto &entry = m_table[hash % m_table.size()];
+        auto tt_move = libataxx::Move::nomove();
+
+        if (entry.hash == hash) {
+            tt_move = entry.move;
+
+            if (entry.depth >= depth) {
+                const auto score = from_tt(entry.score, ply);
+                if (entry.bound == Bound::Exact || (entry.bound == Bound::Lower && score >= beta) ||
+                    (entry.bound == Bound::Upper && score <= alpha)) {
+                    return score;
+                }
+            }
+        }
+
+        const auto alpha_original = alpha;
+        auto best_score = -infinity;
+        auto best_move = libataxx::Move::nomove();
+
+        for (const auto &move : ordered_moves(pos, tt_move)) {
+            auto npos = pos;
+            npos.makemove(move);
+            const auto score = -negamax(npos, -beta, -alpha, depth - 1, ply + 1);
+
+            if (m_stopped) {
+                return 0;
+            }
+
+            if (score > best_score) {
+                best_score = score;
+                best_move = move;
+            }
+
+            if (score > alpha) {
+                alpha = score;
+            }
+
+            if (alpha >= beta) {
+                break;
+            }
+        }
+
+        const auto bound = best_score >= beta            ? Bound::Lower
+                           : best_score > alpha_original ? Bound::Exact
+                                                         : Bound::Upper;
+        store(hash, best_move, best_score, depth, bound, ply);
+
+        return best_score;
+    }
+
+    auto store(const std::uint64_t hash,
+               const libataxx::Move move,
+               const int score,
+               const int depth,
+               const Bound bound,
+               const int ply) -> void {
+        m_table[hash % m_table.size()] = TTEntry{hash, move, to_tt(score, ply), depth, bound};
+    }
+
+    std::vector<TTEntry> m_table;
+    std::uint64_t m_nodes = 0;
+    std::uint64_t m_next_check = 0;
+    std::optional<int> m_max_nodes;
+    std::optional<std::chrono::steady_clock::time_point> m_deadline;
+    // When not to start another iteration
+    std::optional<std::chrono::steady_clock::time_point> m_soft_deadline;
+    bool m_stopped = false;
+};
+
+#endif
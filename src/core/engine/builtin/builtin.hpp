@@ -0,0 +1,60 @@
+#ifndef BUILTIN_BUILTIN_HPP
+#define BUILTIN_BUILTIN_HPP
+
+#include <functional>
+#include <libataxx/move.hpp>
+#include <libataxx/position.hpp>
+#include <string>
+#include "../engine.hpp"
+
+// Engines that run in our own process
+// search() gives the move directly, so games between them don't need to go through move strings
+class BuiltinEngine : public Engine {
+   public:
+    [[nodiscard]] BuiltinEngine(std::function<void(const std::string &msg)> send = {},
+                                std::function<void(const std::string &msg)> recv = {})
+        : Engine(send, recv) {
+    }
+
+    // Always returns a legal move, or a nullmove if the game is over
+    [[nodiscard]] virtual auto search(const libataxx::Position &pos,
+                                      const SearchSettings &settings) -> libataxx::Move = 0;
+
+    virtual auto init() -> void override {
+    }
+
+    virtual auto isready() -> void override {
+    }
+
+    virtual auto newgame() -> void override {
+    }
+
+    using Engine::position;
+
+    virtual auto position(const libataxx::Position &pos) -> void override {
+        m_pos = pos;
+    }
+
+    virtual auto set_option(const std::string &, const std::string &) -> void override {
+    }
+
+    [[nodiscard]] virtual auto go(const SearchSettings &settings) -> std::string override {
+        return static_cast<std::string>(search(m_pos, settings));
+    }
+
+   protected:
+    [[nodiscard]] virtual auto is_running() -> bool override {
+        return true;
+    }
+
+    virtual auto quit() -> void override {
+    }
+
+    virtual auto stop() -> void override {
+    }
+
+   private:
+    libataxx::Position m_pos;
+};
+
+#endif
@@ -3,63 +3,35 @@
 
 #include <functional>
 #include <string>
-#include "../engine.hpp"
+#include "builtin.hpp"
 
-class LeastCapturesBuiltin final : public Engine {
+class LeastCapturesBuiltin final : public BuiltinEngine {
    public:
     [[nodiscard]] LeastCapturesBuiltin(std::function<void(const std::string &msg)> send = {},
                                        std::function<void(const std::string &msg)> recv = {})
-        : Engine(send, recv) {
+        : BuiltinEngine(send, recv) {
     }
 
-    virtual auto init() -> void override {
-    }
-
-    virtual auto isready() -> void override {
-    }
-
-    virtual auto newgame() -> void override {
-    }
-
-    virtual auto quit() -> void override {
-    }
-
-    virtual auto stop() -> void override {
-    }
-
-    virtual auto position(const libataxx::Position &pos) -> void override {
-        m_pos = pos;
-    }
-
-    virtual auto set_option(const std::string &, const std::string &) -> void override {
-    }
-
-    [[nodiscard]] virtual auto go(const SearchSettings &) -> std::string override {
-        if (m_pos.is_gameover()) {
-            return "0000";
+    [[nodiscard]] virtual auto search(const libataxx::Position &pos,
+                                      const SearchSettings &) -> libataxx::Move override {
+        if (pos.is_gameover()) {
+            return libataxx::Move::nullmove();
         }
 
-        const auto moves = m_pos.legal_moves();
+        const auto moves = pos.legal_moves();
         auto best_score = -1'000'000;
         auto best_move = libataxx::Move::nullmove();
 
         for (const auto &move : moves) {
-            const auto score = -(m_pos.count_captures(move) + move.is_single());
+            const auto score = -(pos.count_captures(move) + move.is_single());
             if (score > best_score) {
                 best_score = score;
                 best_move = move;
             }
         }
 
-        return static_cast<std::string>(best_move);
-    }
-
-    [[nodiscard]] virtual auto is_running() -> bool override {
-        return true;
+        return best_move;
     }
-
-   private:
-    libataxx::Position m_pos;
 };
 
 #endif
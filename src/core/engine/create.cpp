@@ -1,4 +1,5 @@
 #include "create.hpp"
+#include "builtin/alphabeta.hpp"
 #include "builtin/least_captures.hpp"
 #include "builtin/most_captures.hpp"
 #include "builtin/random.hpp"
@@ -16,7 +17,7 @@
     if (settings.builtin.empty()) {
         switch (settings.proto) {
             case EngineProtocol::UAI:
-                engine = std::make_shared<UAIEngine>(settings.path, settings.arguments, send, recv);
+                engine = std::make_shared<UAIEngine>(settings.path, settings.arguments, settings.send_moves, send, recv);
                 break;
             case EngineProtocol::FSF:
                 engine = std::make_shared<FairyStockfish>(settings.path, settings.arguments, send, recv);
@@ -36,6 +37,9 @@
         } else if (settings.builtin == "leastcaptures" || settings.builtin == "least-captures" ||
                    settings.builtin == "least captures") {
             engine = std::make_shared<LeastCapturesBuiltin>(send, recv);
+        } else if (settings.builtin == "alphabeta" || settings.builtin == "alpha-beta" ||
+                   settings.builtin == "alpha beta") {
+            engine = std::make_shared<AlphaBetaBuiltin>(send, recv);
         } else {
             throw std::invalid_argument("Unknown engine builtin");
         }
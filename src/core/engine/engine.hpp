@@ -1,11 +1,22 @@
 #ifndef ENGINE_HPP
 #define ENGINE_HPP
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <libataxx/position.hpp>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <vector>
 #include "settings.hpp"
 
+// Thrown when an engine doesn't reply before its deadline
+class EngineTimeout : public std::runtime_error {
+   public:
+    using std::runtime_error::runtime_error;
+};
+
 class Engine {
    public:
     [[nodiscard]] Engine(std::function<void(const std::string &msg)> send = {},
@@ -22,12 +33,66 @@ class Engine {
 
     virtual auto position(const libataxx::Position &pos) -> void = 0;
 
+    // The game so far, as the start position and the moves played from it to reach pos
+    // Engines that can't make use of the moves are only sent the position reached
+    virtual auto position(const libataxx::Position &,
+                          const std::vector<libataxx::Move> &,
+                          const libataxx::Position &pos) -> void {
+        position(pos);
+    }
+
     virtual auto set_option(const std::string &name, const std::string &value) -> void = 0;
 
     virtual auto isready() -> void = 0;
 
     virtual auto newgame() -> void = 0;
 
+    // Think about the position already sent on the opponent's time, without replying
+    // Only for engines that can ponder, the search ends with ponderhit() or stop_pondering()
+    virtual auto ponder(const SearchSettings &) -> void {
+        throw std::logic_error("Engine can't ponder");
+    }
+
+    // The opponent played the move pondered on, carry on searching on our own time
+    [[nodiscard]] virtual auto ponderhit() -> std::string {
+        throw std::logic_error("Engine can't ponder");
+    }
+
+    // The opponent played something else, the search is thrown away
+    virtual auto stop_pondering() -> void {
+        throw std::logic_error("Engine can't ponder");
+    }
+
+    // Only run on the given cores from now on, engines that aren't a separate process ignore this
+    virtual auto set_affinity(const std::vector<int> &) -> void {
+    }
+
+    // Stop waiting for replies after this point, and throw EngineTimeout instead
+    auto set_deadline(const std::optional<std::chrono::steady_clock::time_point> deadline) noexcept -> void {
+        m_deadline = deadline;
+    }
+
+    // While waiting on a reply, tell the engine to stop searching as soon as this is set
+    // The engine still replies as it normally would, just sooner
+    auto set_interrupt(const std::atomic<bool> *interrupt) noexcept -> void {
+        m_interrupt = interrupt;
+    }
+
+    // Engines that stopped responding shouldn't be used again
+    [[nodiscard]] auto is_broken() const noexcept -> bool {
+        return m_broken;
+    }
+
+    // When the engine first replied after we last sent it something, if it has
+    [[nodiscard]] auto first_reply_time() const noexcept -> std::optional<std::chrono::steady_clock::time_point> {
+        return m_first_reply;
+    }
+
+    // The reply the engine expected to its last move, if it said
+    [[nodiscard]] auto ponder_move() const noexcept -> const std::optional<std::string> & {
+        return m_ponder_move;
+    }
+
    protected:
     [[nodiscard]] virtual auto is_running() -> bool = 0;
 
@@ -37,6 +102,11 @@ class Engine {
 
     std::function<void(const std::string &msg)> m_send;
     std::function<void(const std::string &msg)> m_recv;
+    std::optional<std::chrono::steady_clock::time_point> m_deadline;
+    const std::atomic<bool> *m_interrupt = nullptr;
+    std::optional<std::chrono::steady_clock::time_point> m_first_reply;
+    std::optional<std::string> m_ponder_move;
+    bool m_broken = false;
 };
 
 #endif
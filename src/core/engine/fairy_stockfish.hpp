@@ -2,6 +2,8 @@
 #define FAIRY_STOCKFISH_ENGINE_PROCESS_HPP
 
 #include <libataxx/position.hpp>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <utils.hpp>
@@ -36,13 +38,13 @@
     return nfen;
 }
 
-class FairyStockfish final : public ProcessEngine {
+class FairyStockfish final : public AsyncEngine {
    public:
     [[nodiscard]] FairyStockfish(const std::string &path,
                                  const std::string &arguments,
                                  std::function<void(const std::string &msg)> send = {},
                                  std::function<void(const std::string &msg)> recv = {})
-        : ProcessEngine(path, arguments, send, recv) {
+        : AsyncEngine(path, arguments, send, recv) {
     }
 
     ~FairyStockfish() {
@@ -58,7 +60,7 @@ class FairyStockfish final : public ProcessEngine {
     }
 
     virtual void isready() override {
-        send("isready");
+        request_isready();
         wait_for("readyok");
     }
 
@@ -74,6 +76,8 @@ class FairyStockfish final : public ProcessEngine {
         send("stop");
     }
 
+    using Engine::position;
+
     virtual auto position(const libataxx::Position &pos) -> void override {
         const auto nfen = fen_to_fsf_fen(pos.get_fen());
         send("position fen " + nfen);
@@ -84,50 +88,92 @@ class FairyStockfish final : public ProcessEngine {
     }
 
     [[nodiscard]] virtual auto go(const SearchSettings &settings) -> std::string override {
+        request_go(settings);
+        return wait_for_move();
+    }
+
+    virtual auto ponder(const SearchSettings &settings) -> void override {
+        send("go ponder" + search_limits(settings));
+        flush();
+    }
+
+    [[nodiscard]] virtual auto ponderhit() -> std::string override {
+        send("ponderhit");
+        return wait_for_move();
+    }
+
+    virtual auto stop_pondering() -> void override {
+        send("stop");
+        static_cast<void>(wait_for_move());
+    }
+
+    virtual auto request_isready() -> void override {
+        send("isready");
+    }
+
+    [[nodiscard]] virtual auto is_isready_reply(const std::string_view line) const -> bool override {
+        return line == "readyok";
+    }
+
+    virtual auto request_go(const SearchSettings &settings) -> void override {
+        send("go" + search_limits(settings));
+    }
+
+    [[nodiscard]] virtual auto parse_go_reply(const std::string_view line) const
+        -> std::optional<std::string_view> override {
+        // Most of the output will be info lines, don't bother splitting those
+        if (!line.starts_with("bestmove")) {
+            return std::nullopt;
+        }
+
+        const auto parts = utils::split(line);
+        if (parts.size() < 2 || parts[0] != "bestmove") {
+            return std::nullopt;
+        }
+
+        return parts[1];
+    }
+
+   private:
+    // Everything in the go command after "go"
+    [[nodiscard]] static auto search_limits(const SearchSettings &settings) -> std::string {
         switch (settings.type) {
             case SearchSettings::Type::Time: {
                 auto str = std::string();
-                str += "go";
                 str += " wtime " + std::to_string(settings.btime);
                 str += " btime " + std::to_string(settings.wtime);
                 str += " winc " + std::to_string(settings.binc);
                 str += " binc " + std::to_string(settings.winc);
-                send(str);
-                break;
+                return str;
             }
             case SearchSettings::Type::Movetime:
-                send("go movetime " + std::to_string(settings.movetime));
-                break;
+                return " movetime " + std::to_string(settings.movetime);
             case SearchSettings::Type::Depth:
-                send("go depth " + std::to_string(settings.ply));
-                break;
+                return " depth " + std::to_string(settings.ply);
             case SearchSettings::Type::Nodes:
-                send("go nodes " + std::to_string(settings.nodes));
-                break;
+                return " nodes " + std::to_string(settings.nodes);
             default:
-                return {};
+                throw std::invalid_argument("Unknown search type");
         }
+    }
 
+    // Wait for the reply to a go command, noting the move the engine expects in reply
+    [[nodiscard]] auto wait_for_move() -> std::string {
         auto movestr = std::string("0000");
+        m_ponder_move.reset();
 
-        wait_for([&movestr](const std::string_view msg) {
-            const auto parts = utils::split(msg);
-            auto got_bestmove = false;
-
-            for (std::size_t i = 0; i < parts.size(); i += 2) {
-                if (parts[i] == "bestmove") {
-                    movestr = parts[i + 1];
-                    got_bestmove = true;
-                }
+        wait_for([this, &movestr](const std::string_view msg) {
+            const auto reply = parse_go_reply(msg);
+            if (reply) {
+                movestr = *reply;
+                m_ponder_move = parse_ponder_move(msg);
             }
-
-            return got_bestmove;
+            return reply.has_value();
         });
 
         return movestr;
     }
 
-   private:
     auto wait_for(const std::string &msg) -> void {
         while (is_running()) {
             const auto line = get_output();
@@ -48,6 +48,8 @@ class KataGo final : public ProcessEngine {
     virtual void stop() override {
     }
 
+    using Engine::position;
+
     virtual auto position(const libataxx::Position &pos) -> void override {
         m_is_black = pos.get_turn() == libataxx::Side::Black;
 
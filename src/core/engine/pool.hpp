@@ -0,0 +1,113 @@
+#ifndef ENGINE_POOL_HPP
+#define ENGINE_POOL_HPP
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "create.hpp"
+#include "engine.hpp"
+#include "settings.hpp"
+
+struct EnginePoolStats {
+    int created = 0;
+    int reused = 0;
+    std::int64_t startup_us = 0;
+};
+
+// Engines that have already been started, shared by every worker
+// Idle engines are handed to whichever worker asks for them next, so we don't have to
+// start a new process and wait for it to initialise every game
+class EnginePool {
+   public:
+    [[nodiscard]] EnginePool(const std::size_t max_engines) : m_max_engines(max_engines) {
+    }
+
+    // Take an idle engine with the given id if there is one
+    [[nodiscard]] auto try_acquire(const int id) -> std::shared_ptr<Engine> {
+        std::lock_guard lock(m_mutex);
+
+        for (auto iter = m_idle.begin(); iter != m_idle.end(); ++iter) {
+            if (iter->first == id) {
+                auto engine = iter->second;
+                m_idle.erase(iter);
+                m_stats.reused++;
+                return engine;
+            }
+        }
+
+        return {};
+    }
+
+    // Start a new engine, making room for it by removing the oldest idle engine if we're at the limit
+    [[nodiscard]] auto create(const EngineSettings &settings,
+                              std::function<void(const std::string &msg)> send = {},
+                              std::function<void(const std::string &msg)> recv = {}) -> std::shared_ptr<Engine> {
+        std::shared_ptr<Engine> evicted;
+
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_num_engines >= m_max_engines && !m_idle.empty()) {
+                evicted = std::move(m_idle.front().second);
+                m_idle.erase(m_idle.begin());
+                m_num_engines--;
+            }
+            m_num_engines++;
+        }
+
+        // Shut down the old engine without holding the lock
+        evicted.reset();
+
+        try {
+            const auto t0 = std::chrono::steady_clock::now();
+            auto engine = make_engine(settings, send, recv);
+            const auto t1 = std::chrono::steady_clock::now();
+
+            std::lock_guard lock(m_mutex);
+            m_stats.created++;
+            m_stats.startup_us += std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+
+            return engine;
+        } catch (...) {
+            std::lock_guard lock(m_mutex);
+            m_num_engines--;
+            throw;
+        }
+    }
+
+    // Return an engine so that it can be used again
+    auto release(const int id, std::shared_ptr<Engine> engine) -> void {
+        assert(engine);
+        std::lock_guard lock(m_mutex);
+        m_idle.emplace_back(id, std::move(engine));
+    }
+
+    // Stop using an engine that might be in a bad state, it'll be replaced next time it's needed
+    auto discard(std::shared_ptr<Engine> engine) -> void {
+        assert(engine);
+        {
+            std::lock_guard lock(m_mutex);
+            m_num_engines--;
+        }
+        engine.reset();
+    }
+
+    [[nodiscard]] auto stats() const -> EnginePoolStats {
+        std::lock_guard lock(m_mutex);
+        return m_stats;
+    }
+
+   private:
+    mutable std::mutex m_mutex;
+    std::size_t m_max_engines = 0;
+    std::size_t m_num_engines = 0;
+    std::vector<std::pair<int, std::shared_ptr<Engine>>> m_idle;
+    EnginePoolStats m_stats;
+};
+
+#endif
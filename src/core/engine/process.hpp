@@ -1,12 +1,30 @@
 #ifndef ENGINE_PROCESS_HPP
 #define ENGINE_PROCESS_HPP
 
+#include <algorithm>
 #include <boost/process.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <functional>
+#include <optional>
 #include <string>
-#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <utils.hpp>
+#include <vector>
 #include "engine.hpp"
 
+#ifndef _WIN32
+#include <cerrno>
+#include <poll.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 class ProcessEngine : public Engine {
    public:
    protected:
@@ -18,50 +36,249 @@ class ProcessEngine : public Engine {
           m_child(path + (arguments.empty() ? "" : (" " + arguments)),
                   boost::process::start_dir(std::filesystem::path(path).parent_path().string()),
                   boost::process::std_out > m_out,
-                  boost::process::std_in < m_in) {
+                  boost::process::std_in < m_in),
+          m_read_buffer(4096) {
     }
 
     virtual ~ProcessEngine() {
+        // Engines that stopped responding might never exit on their own
+        if (m_broken) {
+            std::error_code ec;
+            m_child.terminate(ec);
+            return;
+        }
+
         if (is_running()) {
+            try {
+                flush();
+            } catch (...) {
+            }
             m_in.close();
             m_out.close();
             m_child.wait();
         }
     }
 
+    virtual auto set_affinity(const std::vector<int> &cores) -> void override {
+#ifdef __linux__
+        if (cores == m_affinity) {
+            return;
+        }
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const auto core : cores) {
+            if (core >= 0 && core < CPU_SETSIZE) {
+                CPU_SET(core, &set);
+            }
+        }
+
+        // Threads the engine has already started have to be moved one at a time, new ones inherit it
+        // Threads can exit while we're doing this, so failures are ignored
+        const auto tasks = std::filesystem::path("/proc") / std::to_string(m_child.id()) / "task";
+        std::error_code ec;
+        auto iter = std::filesystem::directory_iterator(tasks, ec);
+        if (ec) {
+            sched_setaffinity(m_child.id(), sizeof(set), &set);
+        }
+        for (; !ec && iter != std::filesystem::directory_iterator(); iter.increment(ec)) {
+            if (const auto tid = std::atoi(iter->path().filename().c_str()); tid > 0) {
+                sched_setaffinity(tid, sizeof(set), &set);
+            }
+        }
+
+        m_affinity = cores;
+#endif
+    }
+
     [[nodiscard]] virtual auto is_running() -> bool override {
-        return m_child.running();
+        return !m_eof && !m_broken && m_child.running();
     }
 
-    auto send(const std::string &msg) -> void {
+    // Commands are collected and only written once we need a reply
+    auto send(const std::string_view msg) -> void {
         if (m_send) {
-            m_send(msg);
+            m_send(std::string(msg));
         }
-        m_in << msg;
+        m_write_buffer += msg;
 #ifdef _WIN32
-        m_in << "\r";
+        m_write_buffer += '\r';
 #endif
-        m_in << std::endl;
+        m_write_buffer += '\n';
     }
 
-    [[nodiscard]] auto get_output() -> std::string {
-        std::string line;
-        std::getline(m_out, line);
-#ifdef _WIN32
-        if (line.back() == '\r') {
-            line.pop_back();
+    // The line returned is only valid until the next call
+    [[nodiscard]] auto get_output() -> std::string_view {
+        flush();
+
+        while (true) {
+            if (const auto line = next_line()) {
+                return *line;
+            }
+
+            if (!read_available()) {
+                return {};
+            }
+        }
+    }
+
+   public:
+    // Where to wait for output when waiting on more than one engine at a time
+    [[nodiscard]] auto native_handle() -> boost::process::pipe::native_handle_type {
+        return m_out.native_source();
+    }
+
+    // Take the next complete line from the output that's already been read, if there is one
+    // The line returned is only valid until the next call
+    [[nodiscard]] auto next_line() -> std::optional<std::string_view> {
+        const auto begin = m_read_buffer.data() + m_read_pos;
+        const auto end = m_read_buffer.data() + m_write_pos;
+        const auto newline = std::find(begin, end, '\n');
+
+        if (newline == end) {
+            return std::nullopt;
+        }
+
+        auto line = std::string_view(begin, newline - begin);
+        m_read_pos += line.size() + 1;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
         }
-#endif
         if (m_recv) {
-            m_recv(line);
+            m_recv(std::string(line));
         }
         return line;
     }
 
+    // Read from the engine once, this blocks if there's nothing to read
+    // Returns false if the engine has closed its output
+    auto read_available() -> bool {
+#ifndef _WIN32
+        // Wait for output until the deadline, and keep an eye out for being interrupted
+        while (m_deadline || is_interruptible()) {
+            auto timeout = -1;
+            auto is_late = false;
+            if (m_deadline) {
+                const auto now = std::chrono::steady_clock::now();
+                const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*m_deadline - now).count();
+                timeout = static_cast<int>(std::max<decltype(remaining)>(remaining, 0));
+                is_late = remaining <= 0;
+            }
+            if (is_interruptible() && (timeout < 0 || timeout > interrupt_poll_ms)) {
+                timeout = interrupt_poll_ms;
+            }
+
+            pollfd fd = {m_out.native_source(), POLLIN, 0};
+            const auto ready = poll(&fd, 1, timeout);
+
+            if (ready > 0) {
+                break;
+            } else if (ready < 0 && errno != EINTR) {
+                throw std::system_error(errno, std::generic_category(), "poll");
+            } else if (ready == 0 && is_late) {
+                abandon();
+                throw EngineTimeout("Engine timed out");
+            }
+
+            // The reply to the stop comes back like any other
+            if (is_interruptible() && m_interrupt->load(std::memory_order_relaxed)) {
+                stop();
+                flush();
+                m_interrupted = true;
+            }
+        }
+#endif
+
+        // Move the partial line to the start of the buffer, and grow it if the line is too long to fit
+        std::memmove(m_read_buffer.data(), m_read_buffer.data() + m_read_pos, m_write_pos - m_read_pos);
+        m_write_pos -= m_read_pos;
+        m_read_pos = 0;
+        if (m_write_pos == m_read_buffer.size()) {
+            m_read_buffer.resize(2 * m_read_buffer.size());
+        }
+
+        const auto space = static_cast<int>(m_read_buffer.size() - m_write_pos);
+        const auto num_read = m_out.read(m_read_buffer.data() + m_write_pos, space);
+        if (num_read <= 0) {
+            m_eof = true;
+            return false;
+        }
+        m_write_pos += num_read;
+
+        if (!m_first_reply) {
+            m_first_reply = std::chrono::steady_clock::now();
+        }
+
+        return true;
+    }
+
+    // Stop talking to the engine, it'll be killed rather than asked to quit
+    auto abandon() noexcept -> void {
+        m_broken = true;
+    }
+
+    auto flush() -> void {
+        if (m_write_buffer.empty()) {
+            return;
+        }
+
+        std::size_t written = 0;
+        while (written < m_write_buffer.size()) {
+            const auto remaining = static_cast<int>(m_write_buffer.size() - written);
+            written += m_in.write(m_write_buffer.data() + written, remaining);
+        }
+        m_write_buffer.clear();
+        m_first_reply.reset();
+        m_interrupted = false;
+    }
+
    private:
-    boost::process::opstream m_in;
-    boost::process::ipstream m_out;
+    // How often to check for being interrupted while waiting on a reply
+    static constexpr int interrupt_poll_ms = 20;
+
+    // Engines are only told to stop once per command
+    [[nodiscard]] auto is_interruptible() const noexcept -> bool {
+        return m_interrupt && !m_interrupted;
+    }
+
+    boost::process::pipe m_in;
+    boost::process::pipe m_out;
     boost::process::child m_child;
+    std::string m_write_buffer;
+    std::vector<char> m_read_buffer;
+    std::size_t m_read_pos = 0;
+    std::size_t m_write_pos = 0;
+    std::vector<int> m_affinity;
+    bool m_eof = false;
+    bool m_interrupted = false;
+};
+
+// Engines whose replies can be waited on by someone else instead of blocking in wait_for()
+// Requests are buffered until flush() is called
+class AsyncEngine : public ProcessEngine {
+   public:
+    virtual auto request_isready() -> void = 0;
+
+    [[nodiscard]] virtual auto is_isready_reply(const std::string_view line) const -> bool = 0;
+
+    virtual auto request_go(const SearchSettings &settings) -> void = 0;
+
+    // The move string if this line is the reply to a go command
+    // The view is only valid as long as the line is
+    [[nodiscard]] virtual auto parse_go_reply(const std::string_view line) const
+        -> std::optional<std::string_view> = 0;
+
+   protected:
+    using ProcessEngine::ProcessEngine;
+
+    // The reply the engine expects from a "bestmove <move> ponder <move>" line, if it gave one
+    [[nodiscard]] static auto parse_ponder_move(const std::string_view line) -> std::optional<std::string> {
+        const auto parts = utils::split(line);
+        if (parts.size() >= 4 && parts[0] == "bestmove" && parts[2] == "ponder") {
+            return std::string(parts[3]);
+        }
+        return std::nullopt;
+    }
 };
 
 #endif
@@ -72,6 +72,12 @@ struct EngineSettings {
     std::string arguments;
     SearchSettings tc;
     std::vector<std::pair<std::string, std::string>> options;
+    // Whether to wait for the engine to be ready before every move
+    bool isready = true;
+    // Whether to send the moves played since the start position, instead of just the current position
+    bool send_moves = false;
+    // Whether to let the engine think on its opponent's time
+    bool ponder = false;
 };
 
 #endif
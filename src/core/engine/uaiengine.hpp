@@ -1,19 +1,28 @@
 #ifndef UAI_ENGINE_PROCESS_HPP
 #define UAI_ENGINE_PROCESS_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <libataxx/move.hpp>
 #include <libataxx/position.hpp>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <utils.hpp>
+#include <vector>
 #include "process.hpp"
 
-class UAIEngine final : public ProcessEngine {
+class UAIEngine final : public AsyncEngine {
    public:
+    // Engines that send moves are given the start position and the moves played since, rather than just the current
+    // position, so they can keep their hash table and repetition history through the game
     [[nodiscard]] UAIEngine(const std::string &path,
                             const std::string &arguments,
+                            const bool send_moves,
                             std::function<void(const std::string &msg)> send = {},
                             std::function<void(const std::string &msg)> recv = {})
-        : ProcessEngine(path, arguments, send, recv) {
+        : AsyncEngine(path, arguments, send, recv), m_send_moves(send_moves) {
     }
 
     ~UAIEngine() {
@@ -29,12 +38,13 @@ class UAIEngine final : public ProcessEngine {
     }
 
     virtual void isready() override {
-        send("isready");
+        request_isready();
         wait_for("readyok");
     }
 
     virtual void newgame() override {
         send("uainewgame");
+        m_position.clear();
     }
 
     virtual void quit() override {
@@ -49,55 +59,124 @@ class UAIEngine final : public ProcessEngine {
         send("position fen " + pos.get_fen());
     }
 
+    virtual auto position(const libataxx::Position &startpos,
+                          const std::vector<libataxx::Move> &moves,
+                          const libataxx::Position &pos) -> void override {
+        if (!m_send_moves) {
+            position(pos);
+            return;
+        }
+
+        // Carry on from the last position command, unless it was from a different game
+        // or ended with a move we pondered on that wasn't played
+        if (m_position.empty() || moves.size() < m_num_moves || startpos.get_hash() != m_startpos_hash ||
+            (m_num_moves > 0 && moves[m_num_moves - 1] != m_last_move)) {
+            m_position = "position fen " + startpos.get_fen();
+            m_num_moves = 0;
+            m_startpos_hash = startpos.get_hash();
+        }
+
+        // Only the moves played since then need adding
+        for (; m_num_moves < moves.size(); ++m_num_moves) {
+            m_position += m_num_moves == 0 ? " moves " : " ";
+            m_position += static_cast<std::string>(moves[m_num_moves]);
+            m_last_move = moves[m_num_moves];
+        }
+
+        send(m_position);
+    }
+
     virtual auto set_option(const std::string &name, const std::string &value) -> void override {
         send("setoption name " + name + " value " + value);
     }
 
     [[nodiscard]] virtual auto go(const SearchSettings &settings) -> std::string override {
+        request_go(settings);
+        return wait_for_move();
+    }
+
+    virtual auto ponder(const SearchSettings &settings) -> void override {
+        send("go ponder" + search_limits(settings));
+        flush();
+    }
+
+    [[nodiscard]] virtual auto ponderhit() -> std::string override {
+        send("ponderhit");
+        return wait_for_move();
+    }
+
+    virtual auto stop_pondering() -> void override {
+        send("stop");
+        static_cast<void>(wait_for_move());
+    }
+
+    virtual auto request_isready() -> void override {
+        send("isready");
+    }
+
+    [[nodiscard]] virtual auto is_isready_reply(const std::string_view line) const -> bool override {
+        return line == "readyok";
+    }
+
+    virtual auto request_go(const SearchSettings &settings) -> void override {
+        send("go" + search_limits(settings));
+    }
+
+    [[nodiscard]] virtual auto parse_go_reply(const std::string_view line) const
+        -> std::optional<std::string_view> override {
+        // Most of the output will be info lines, don't bother splitting those
+        if (!line.starts_with("bestmove")) {
+            return std::nullopt;
+        }
+
+        const auto parts = utils::split(line);
+        if (parts.size() < 2 || parts[0] != "bestmove") {
+            return std::nullopt;
+        }
+
+        return parts[1];
+    }
+
+   private:
+    // Everything in the go command after "go"
+    [[nodiscard]] static auto search_limits(const SearchSettings &settings) -> std::string {
         switch (settings.type) {
             case SearchSettings::Type::Time: {
                 auto str = std::string();
-                str += "go";
                 str += " btime " + std::to_string(settings.btime);
                 str += " wtime " + std::to_string(settings.wtime);
                 str += " binc " + std::to_string(settings.binc);
                 str += " winc " + std::to_string(settings.winc);
-                send(str);
-                break;
+                return str;
             }
             case SearchSettings::Type::Movetime:
-                send("go movetime " + std::to_string(settings.movetime));
-                break;
+                return " movetime " + std::to_string(settings.movetime);
             case SearchSettings::Type::Depth:
-                send("go depth " + std::to_string(settings.ply));
-                break;
+                return " depth " + std::to_string(settings.ply);
             case SearchSettings::Type::Nodes:
-                send("go nodes " + std::to_string(settings.nodes));
-                break;
+                return " nodes " + std::to_string(settings.nodes);
             default:
-                return {};
+                throw std::invalid_argument("Unknown search type");
         }
+    }
 
+    // Wait for the reply to a go command, noting the move the engine expects in reply
+    [[nodiscard]] auto wait_for_move() -> std::string {
         auto movestr = std::string("0000");
+        m_ponder_move.reset();
 
-        wait_for([&movestr](const std::string_view msg) {
-            const auto parts = utils::split(msg);
-            auto got_bestmove = false;
-
-            for (std::size_t i = 0; i < parts.size(); i += 2) {
-                if (parts[i] == "bestmove") {
-                    movestr = parts[i + 1];
-                    got_bestmove = true;
-                }
+        wait_for([this, &movestr](const std::string_view msg) {
+            const auto reply = parse_go_reply(msg);
+            if (reply) {
+                movestr = *reply;
+                m_ponder_move = parse_ponder_move(msg);
             }
-
-            return got_bestmove;
+            return reply.has_value();
         });
 
         return movestr;
     }
 
-   private:
     auto wait_for(const std::string &msg) -> void {
         while (is_running()) {
             const auto line = get_output();
@@ -114,6 +193,13 @@ class UAIEngine final : public ProcessEngine {
             exit = func(line);
         }
     }
+
+    bool m_send_moves = false;
+    // The last position command sent, built up a move at a time
+    std::string m_position;
+    std::size_t m_num_moves = 0;
+    std::uint64_t m_startpos_hash = 0;
+    libataxx::Move m_last_move = libataxx::Move::nomove();
 };
 
 #endif
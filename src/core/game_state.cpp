@@ -0,0 +1,174 @@
+#include "game_state.hpp"
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "ataxx/adjudicate.hpp"
+#include "ataxx/parse_move.hpp"
+
+[[nodiscard]] constexpr auto make_win_for(const libataxx::Side s) noexcept {
+    return s == libataxx::Side::Black ? libataxx::Result::BlackWin : libataxx::Result::WhiteWin;
+}
+
+static_assert(make_win_for(libataxx::Side::Black) == libataxx::Result::BlackWin);
+static_assert(make_win_for(libataxx::Side::White) == libataxx::Result::WhiteWin);
+
+GameState::GameState(const AdjudicationSettings &adjudication, const GameSettings &game)
+    : m_adjudication(adjudication),
+      m_game(game),
+      m_pos(game.startpos),
+      m_tc1(game.engine1.tc),
+      m_tc2(game.engine2.tc) {
+    assert(game.engine1.id != game.engine2.id);
+    m_info.startpos = m_pos;
+}
+
+[[nodiscard]] auto GameState::check_finished() -> bool {
+    if (m_info.result != libataxx::Result::None) {
+        return true;
+    }
+
+    if (m_pos.is_gameover()) {
+        return true;
+    }
+
+    if (const auto adjudication = adjudicate(m_pos, m_adjudication, m_adjudication_state)) {
+        m_info.result = adjudication->result;
+        m_info.reason = adjudication->reason;
+        return true;
+    }
+
+    return false;
+}
+
+[[nodiscard]] auto GameState::time_limit() const noexcept -> std::optional<std::chrono::milliseconds> {
+    const auto &tc_us = search_settings();
+
+    switch (tc_us.type) {
+        case SearchSettings::Type::Movetime:
+            return std::chrono::milliseconds(tc_us.movetime + m_adjudication.timeout_buffer);
+        case SearchSettings::Type::Time: {
+            const auto remaining = m_pos.get_turn() == libataxx::Side::Black ? tc_us.btime : tc_us.wtime;
+            return std::chrono::milliseconds(remaining + m_adjudication.timeout_buffer);
+        }
+        default:
+            return std::nullopt;
+    }
+}
+
+auto GameState::apply(const std::string_view movestr,
+                      const std::chrono::microseconds movetime,
+                      const std::chrono::microseconds first_reply) -> void {
+    assert(m_info.result == libataxx::Result::None);
+
+    libataxx::Move move;
+
+    try {
+        // Parse move string
+        move = parse_move(std::string(movestr));
+
+        // Illegal move
+        if (!m_pos.is_legal_move(move)) {
+            throw std::logic_error("Illegal move");
+        }
+    } catch (...) {
+        m_info.result = make_win_for(!m_pos.get_turn());
+        m_info.reason = ResultReason::IllegalMove;
+        std::cout << "Illegal move \"" << movestr << "\" played by "
+                  << (m_pos.get_turn() == libataxx::Side::Black ? m_game.engine1.name : m_game.engine2.name)
+                  << "\n\n";
+        return;
+    }
+
+    apply(move, movetime, first_reply);
+}
+
+auto GameState::apply(const libataxx::Move move,
+                      const std::chrono::microseconds movetime,
+                      const std::chrono::microseconds first_reply) -> void {
+    assert(m_info.result == libataxx::Result::None);
+    assert(m_pos.is_legal_move(move));
+
+    auto &tc_us = m_pos.get_turn() == libataxx::Side::Black ? m_tc1 : m_tc2;
+
+    // Add move to .pgn
+    m_info.history.emplace_back(move,
+                                std::chrono::duration_cast<std::chrono::milliseconds>(movetime).count(),
+                                first_reply.count(),
+                                movetime.count());
+    m_moves.push_back(move);
+
+    // Charge whole milliseconds to the clock, keeping track of what's left over for next time
+    auto &used_us = m_used_us[m_pos.get_turn() == libataxx::Side::Black ? 0 : 1];
+    const auto charged = static_cast<int>((used_us + movetime.count()) / 1000 - used_us / 1000);
+    used_us += movetime.count();
+
+    // Update clocks
+    if (tc_us.type == SearchSettings::Type::Time) {
+        if (m_pos.get_turn() == libataxx::Side::Black) {
+            m_tc1.btime -= charged;
+            m_tc2.btime -= charged;
+        } else {
+            m_tc1.wtime -= charged;
+            m_tc2.wtime -= charged;
+        }
+    }
+
+    // Out of time?
+    if (tc_us.type == SearchSettings::Type::Movetime) {
+        if (movetime > std::chrono::milliseconds(tc_us.movetime + m_adjudication.timeout_buffer)) {
+            m_info.result = make_win_for(!m_pos.get_turn());
+            m_info.reason = ResultReason::OutOfTime;
+            return;
+        }
+    } else if (tc_us.type == SearchSettings::Type::Time) {
+        if (tc_us.btime <= 0) {
+            m_info.result = libataxx::Result::WhiteWin;
+            m_info.reason = ResultReason::OutOfTime;
+            return;
+        } else if (tc_us.wtime <= 0) {
+            m_info.result = libataxx::Result::BlackWin;
+            m_info.reason = ResultReason::OutOfTime;
+            return;
+        }
+    }
+
+    // Increments
+    if (tc_us.type == SearchSettings::Type::Time) {
+        if (m_pos.get_turn() == libataxx::Side::Black) {
+            m_tc1.btime += tc_us.binc;
+            m_tc2.btime += tc_us.binc;
+        } else {
+            m_tc1.wtime += tc_us.winc;
+            m_tc2.wtime += tc_us.winc;
+        }
+    }
+
+    m_pos.makemove(move);
+}
+
+auto GameState::crash() -> void {
+    m_info.reason = ResultReason::EngineCrash;
+    m_info.result = make_win_for(!m_pos.get_turn());
+}
+
+auto GameState::timeout() -> void {
+    m_info.reason = ResultReason::OutOfTime;
+    m_info.result = make_win_for(!m_pos.get_turn());
+}
+
+auto GameState::abort() -> void {
+    m_info.reason = ResultReason::Aborted;
+    m_info.result = libataxx::Result::None;
+}
+
+[[nodiscard]] auto GameState::finish() -> GameThingy {
+    // Game finished normally
+    if (m_info.result == libataxx::Result::None && m_info.reason != ResultReason::Aborted) {
+        m_info.result = m_pos.get_result();
+    }
+
+    m_info.endpos = m_pos;
+
+    return std::move(m_info);
+}
@@ -0,0 +1,94 @@
+#ifndef GAME_STATE_HPP
+#define GAME_STATE_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <libataxx/position.hpp>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include "ataxx/adjudicate.hpp"
+#include "engine/settings.hpp"
+#include "play.hpp"
+
+// Everything about a game in progress that doesn't involve talking to the engines
+// This lets a game be played a move at a time by whoever is waiting on the engines
+// The adjudication and game settings must outlive the game
+class GameState {
+   public:
+    [[nodiscard]] GameState(const AdjudicationSettings &adjudication, const GameSettings &game);
+
+    // Check if the game has ended, either naturally or by adjudication
+    [[nodiscard]] auto check_finished() -> bool;
+
+    [[nodiscard]] auto position() const noexcept -> const libataxx::Position & {
+        return m_pos;
+    }
+
+    [[nodiscard]] auto startpos() const noexcept -> const libataxx::Position & {
+        return m_info.startpos;
+    }
+
+    // The moves played so far
+    [[nodiscard]] auto history() const noexcept -> const std::vector<MoveThingy> & {
+        return m_info.history;
+    }
+
+    // The same moves without their times, for sending to engines
+    [[nodiscard]] auto moves() const noexcept -> const std::vector<libataxx::Move> & {
+        return m_moves;
+    }
+
+    [[nodiscard]] auto turn() const noexcept -> libataxx::Side {
+        return m_pos.get_turn();
+    }
+
+    // The search settings to send to the engine to move
+    [[nodiscard]] auto search_settings() const noexcept -> const SearchSettings & {
+        return search_settings(m_pos.get_turn());
+    }
+
+    [[nodiscard]] auto search_settings(const libataxx::Side side) const noexcept -> const SearchSettings & {
+        return side == libataxx::Side::Black ? m_tc1 : m_tc2;
+    }
+
+    // How long the engine to move can think before losing on time, if there's a limit
+    [[nodiscard]] auto time_limit() const noexcept -> std::optional<std::chrono::milliseconds>;
+
+    // Play the move the engine to move came up with
+    // The times are measured from when the go command was sent
+    auto apply(const std::string_view movestr,
+               const std::chrono::microseconds movetime,
+               const std::chrono::microseconds first_reply) -> void;
+
+    // Play a move already known to be legal, skipping the parsing and checks
+    auto apply(const libataxx::Move move,
+               const std::chrono::microseconds movetime,
+               const std::chrono::microseconds first_reply) -> void;
+
+    // The engine to move stopped responding
+    auto crash() -> void;
+
+    // The engine to move didn't reply before its time limit
+    auto timeout() -> void;
+
+    // The match stopped before the game could finish, so there's no result
+    auto abort() -> void;
+
+    [[nodiscard]] auto finish() -> GameThingy;
+
+   private:
+    const AdjudicationSettings &m_adjudication;
+    const GameSettings &m_game;
+    AdjudicationState m_adjudication_state;
+    libataxx::Position m_pos;
+    SearchSettings m_tc1;
+    SearchSettings m_tc2;
+    // Time used by black and white, so the clocks aren't charged for truncated milliseconds
+    std::array<std::int64_t, 2> m_used_us = {0, 0};
+    GameThingy m_info;
+    std::vector<libataxx::Move> m_moves;
+};
+
+#endif
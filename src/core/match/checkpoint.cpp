@@ -0,0 +1,275 @@
+#include "checkpoint.hpp"
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <sprt.hpp>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include "../opening_book.hpp"
+#include "../play.hpp"
+#include "llr.hpp"
+#include "settings.hpp"
+#include "tally.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Wait for the file to reach the disk, throws if it can't
+auto sync_file([[maybe_unused]] const std::string &path) -> void {
+#ifndef _WIN32
+    const auto fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "Could not open checkpoint " + path);
+    }
+    const auto err = fsync(fd) == 0 ? 0 : errno;
+    close(fd);
+    if (err != 0) {
+        std::filesystem::remove(path);
+        throw std::system_error(err, std::generic_category(), "Could not sync checkpoint " + path);
+    }
+#endif
+}
+
+// FNV-1a of every opening in order
+[[nodiscard]] auto hash_openings(const OpeningBook &openings) noexcept -> std::uint64_t {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    const auto add = [&hash](const char c) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    };
+
+    for (std::size_t i = 0; i < openings.size(); ++i) {
+        for (const auto c : openings[i]) {
+            add(c);
+        }
+        add('\n');
+    }
+
+    return hash;
+}
+
+}  // namespace
+
+auto Checkpoint::add(const GameInfo &game_info, const GameThingy &game_data) -> void {
+    const auto &name1 = engines.at(game_info.idx_player1);
+    const auto &name2 = engines.at(game_info.idx_player2);
+    auto &score1 = results.scores[name1];
+    auto &score2 = results.scores[name2];
+
+    results.games_started++;
+    results.games_played++;
+    score1.played++;
+    score2.played++;
+
+    switch (game_data.result) {
+        case libataxx::Result::BlackWin:
+            results.black_wins++;
+            score1.wins++;
+            score2.losses++;
+            break;
+        case libataxx::Result::WhiteWin:
+            results.white_wins++;
+            score1.losses++;
+            score2.wins++;
+            break;
+        case libataxx::Result::Draw:
+            results.draws++;
+            score1.draws++;
+            score2.draws++;
+            break;
+        default:
+            break;
+    }
+
+    if (game_data.reason == ResultReason::EngineCrash) {
+        auto &crashed = game_data.result == libataxx::Result::BlackWin ? score2 : score1;
+        crashed.crashes++;
+    }
+
+    // Score the pair once both games have finished, the same way the tally does
+    const auto pair = game_info.id / 2;
+    if (engines.size() == 2 && pair < num_games / 2) {
+        const auto points = ResultsTally::pair_points(game_info.idx_player1, game_data.result);
+        const auto other = half_pairs.find(pair);
+        if (other == half_pairs.end()) {
+            half_pairs.emplace(pair, points);
+        } else {
+            results.pentanomial[points + other->second]++;
+            half_pairs.erase(other);
+        }
+    }
+
+    auto is_black = game_data.startpos.get_turn() == libataxx::Side::Black;
+    for (const auto &move : game_data.history) {
+        auto &latencies = results.latencies[is_black ? name1 : name2];
+        latencies.first_reply.counts[LatencyHistogram::bucket(move.first_reply_us)]++;
+        latencies.move.counts[LatencyHistogram::bucket(move.total_us)]++;
+        is_black = !is_black;
+    }
+
+    // Keep the list of finished games short
+    finished.insert(game_info.id);
+    while (!finished.empty() && *finished.begin() == finished_below) {
+        finished.erase(finished.begin());
+        finished_below++;
+    }
+}
+
+auto check_checkpoint(Checkpoint &checkpoint,
+                      const std::vector<std::string> &engines,
+                      const TournamentType tournament,
+                      const OpeningBook &openings,
+                      const std::size_t num_games) -> void {
+    const auto hash = hash_openings(openings);
+
+    if (!checkpoint.engines.empty()) {
+        if (checkpoint.engines != engines || checkpoint.num_games != num_games) {
+            throw std::invalid_argument("Checkpoint doesn't match the settings");
+        } else if (checkpoint.tournament && *checkpoint.tournament != tournament) {
+            throw std::invalid_argument("Checkpoint is from a different tournament type");
+        } else if (checkpoint.openings_hash && *checkpoint.openings_hash != hash) {
+            throw std::invalid_argument("Checkpoint is from different openings");
+        }
+    }
+
+    checkpoint.engines = engines;
+    checkpoint.num_games = num_games;
+    checkpoint.tournament = tournament;
+    checkpoint.openings_hash = hash;
+}
+
+auto load_checkpoint(const std::string &path) -> std::optional<Checkpoint> {
+    std::ifstream f(path);
+    if (!f.is_open()) {
+        return std::nullopt;
+    }
+
+    nlohmann::ordered_json json;
+    try {
+        f >> json;
+    } catch (...) {
+        throw std::invalid_argument("Failure parsing checkpoint " + path);
+    }
+
+    auto checkpoint = Checkpoint{};
+    checkpoint.seed = json.at("seed").get<std::uint32_t>();
+    checkpoint.num_games = json.at("games").get<std::size_t>();
+    checkpoint.engines = json.at("engines").get<std::vector<std::string>>();
+    if (json.contains("tournament")) {
+        checkpoint.tournament = static_cast<TournamentType>(json.at("tournament").get<int>());
+    }
+    if (json.contains("openings_hash")) {
+        checkpoint.openings_hash = json.at("openings_hash").get<std::uint64_t>();
+    }
+    checkpoint.finished_below = json.at("finished_below").get<std::size_t>();
+    checkpoint.finished = json.at("finished").get<std::set<std::size_t>>();
+
+    const auto &results = json.at("results");
+    checkpoint.results.games_started = results.at("games").get<int>();
+    checkpoint.results.games_played = results.at("games").get<int>();
+    checkpoint.results.black_wins = results.at("black_wins").get<int>();
+    checkpoint.results.white_wins = results.at("white_wins").get<int>();
+    checkpoint.results.draws = results.at("draws").get<int>();
+    if (results.contains("pentanomial")) {
+        checkpoint.results.pentanomial = results.at("pentanomial").get<std::array<int, 5>>();
+    }
+    if (json.contains("half_pairs")) {
+        checkpoint.half_pairs = json.at("half_pairs").get<std::map<std::size_t, int>>();
+    }
+
+    for (const auto &[name, val] : results.at("scores").items()) {
+        auto &score = checkpoint.results.scores[name];
+        score.wins = val.at("wins").get<int>();
+        score.draws = val.at("draws").get<int>();
+        score.losses = val.at("losses").get<int>();
+        score.crashes = val.at("crashes").get<int>();
+        score.played = val.at("played").get<int>();
+
+        auto &latencies = checkpoint.results.latencies[name];
+        latencies.first_reply.counts = val.at("first_reply").get<std::array<int, LatencyHistogram::size>>();
+        latencies.move.counts = val.at("move").get<std::array<int, LatencyHistogram::size>>();
+    }
+
+    return checkpoint;
+}
+
+auto save_checkpoint(const std::string &path, const Checkpoint &checkpoint, const Settings &settings) -> void {
+    nlohmann::ordered_json json;
+    json["seed"] = checkpoint.seed;
+    json["games"] = checkpoint.num_games;
+    json["engines"] = checkpoint.engines;
+    if (checkpoint.tournament) {
+        json["tournament"] = static_cast<int>(*checkpoint.tournament);
+    }
+    if (checkpoint.openings_hash) {
+        json["openings_hash"] = *checkpoint.openings_hash;
+    }
+    json["finished_below"] = checkpoint.finished_below;
+    json["finished"] = checkpoint.finished;
+
+    // Built on its own, references into an ordered_json don't survive more keys being added to it
+    nlohmann::ordered_json results;
+    results["games"] = checkpoint.results.games_played;
+    results["black_wins"] = checkpoint.results.black_wins;
+    results["white_wins"] = checkpoint.results.white_wins;
+    results["draws"] = checkpoint.results.draws;
+    results["pentanomial"] = checkpoint.results.pentanomial;
+
+    for (const auto &[name, score] : checkpoint.results.scores) {
+        auto &val = results["scores"][name];
+        val["wins"] = score.wins;
+        val["draws"] = score.draws;
+        val["losses"] = score.losses;
+        val["crashes"] = score.crashes;
+        val["played"] = score.played;
+
+        const auto iter = checkpoint.results.latencies.find(name);
+        const auto latencies = iter == checkpoint.results.latencies.end() ? Latencies{} : iter->second;
+        val["first_reply"] = latencies.first_reply.counts;
+        val["move"] = latencies.move.counts;
+    }
+
+    json["results"] = std::move(results);
+    json["half_pairs"] = checkpoint.half_pairs;
+
+    // Not needed to resume, the LLR is worked out again from the scores, but useful to look at
+    if (settings.sprt.enabled && checkpoint.engines.size() == 2) {
+        auto &sprt = json["sprt"];
+        sprt["elo0"] = settings.sprt.elo0;
+        sprt["elo1"] = settings.sprt.elo1;
+        sprt["llr"] = match_llr(settings, checkpoint.results);
+        sprt["lbound"] = sprt::get_lbound(settings.sprt.alpha, settings.sprt.beta);
+        sprt["ubound"] = sprt::get_ubound(settings.sprt.alpha, settings.sprt.beta);
+    }
+
+    // Write somewhere else first so the checkpoint is never seen half written
+    const auto tmp_path = path + ".tmp";
+    {
+        std::ofstream f(tmp_path, std::ofstream::trunc);
+        if (!f.is_open()) {
+            throw std::runtime_error("Could not write checkpoint " + tmp_path);
+        }
+        f << json.dump(4) << "\n";
+        f.close();
+
+        // A full disk would otherwise replace the last good checkpoint with a truncated one
+        if (!f.good()) {
+            std::filesystem::remove(tmp_path);
+            throw std::runtime_error("Could not write checkpoint " + tmp_path);
+        }
+    }
+
+    // Make sure it's on disk before it replaces the old one, or a crash could leave neither
+    sync_file(tmp_path);
+
+    std::filesystem::rename(tmp_path, path);
+}
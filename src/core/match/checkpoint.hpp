@@ -0,0 +1,58 @@
+#ifndef MATCH_CHECKPOINT_HPP
+#define MATCH_CHECKPOINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+#include "../tournament/generator.hpp"
+#include "../tournament/types.hpp"
+#include "results.hpp"
+
+class Settings;
+class GameThingy;
+class OpeningBook;
+
+// Everything needed to carry on with a match that was stopped part way through
+struct Checkpoint {
+    // Used to shuffle the openings, so they come out in the same order again
+    std::uint32_t seed = 0;
+    std::size_t num_games = 0;
+    std::vector<std::string> engines;
+    // Which games get played, and from which openings, missing from checkpoints saved by older versions
+    std::optional<TournamentType> tournament;
+    std::optional<std::uint64_t> openings_hash;
+    // Every game before this has finished, as have the ones listed
+    std::size_t finished_below = 0;
+    std::set<std::size_t> finished;
+    // The results of the finished games only
+    Results results;
+    // Pairs of games where only one has finished, and the half points the first engine scored in it
+    std::map<std::size_t, int> half_pairs;
+
+    auto add(const GameInfo &game_info, const GameThingy &game_data) -> void;
+
+    [[nodiscard]] auto num_finished() const noexcept -> std::size_t {
+        return finished_below + finished.size();
+    }
+};
+
+// Throws if the checkpoint is from a different match, which would give nonsense results, otherwise fills in which match
+// it's for if it's a new checkpoint
+// The openings have to be the same ones in the same order, so changing the file or how it's shuffled counts too
+auto check_checkpoint(Checkpoint &checkpoint,
+                      const std::vector<std::string> &engines,
+                      const TournamentType tournament,
+                      const OpeningBook &openings,
+                      const std::size_t num_games) -> void;
+
+// Returns nothing if there's no checkpoint file
+[[nodiscard]] auto load_checkpoint(const std::string &path) -> std::optional<Checkpoint>;
+
+// The file is replaced in one go, so a crash while saving leaves the previous checkpoint intact
+auto save_checkpoint(const std::string &path, const Checkpoint &checkpoint, const Settings &settings) -> void;
+
+#endif
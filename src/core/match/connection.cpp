@@ -0,0 +1,241 @@
+#include "connection.hpp"
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+
+namespace {
+
+// Results are small and sent one at a time, so don't hold them back waiting for more
+auto set_nodelay(const int fd) noexcept -> void {
+    const int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+[[nodiscard]] auto resolve(const std::string &host, const int port, const bool passive) -> addrinfo * {
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+    addrinfo *addresses = nullptr;
+    const auto service = std::to_string(port);
+    const auto err = getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &addresses);
+    if (err != 0) {
+        throw std::runtime_error("Could not resolve " + host + ": " + gai_strerror(err));
+    }
+    return addresses;
+}
+
+}  // namespace
+
+Connection::Connection(const int fd) noexcept : m_fd(fd) {
+    set_nodelay(m_fd);
+}
+
+auto Connection::connect(const std::string &host, const int port) -> Connection {
+    auto *const addresses = resolve(host, port, false);
+
+    auto err = 0;
+    for (auto *address = addresses; address; address = address->ai_next) {
+        const auto fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0) {
+            err = errno;
+            continue;
+        }
+
+        if (::connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+            freeaddrinfo(addresses);
+            return Connection(fd);
+        }
+
+        err = errno;
+        close(fd);
+    }
+
+    freeaddrinfo(addresses);
+    throw std::system_error(err, std::generic_category(), "Could not connect to " + host + ":" + std::to_string(port));
+}
+
+Connection::Connection(Connection &&other) noexcept
+    : m_fd(std::exchange(other.m_fd, -1)), m_buffer(std::move(other.m_buffer)) {
+}
+
+Connection &Connection::operator=(Connection &&other) noexcept {
+    if (this != &other) {
+        if (m_fd >= 0) {
+            close(m_fd);
+        }
+        m_fd = std::exchange(other.m_fd, -1);
+        m_buffer = std::move(other.m_buffer);
+    }
+    return *this;
+}
+
+Connection::~Connection() {
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+}
+
+auto Connection::send(const nlohmann::json &message) -> bool {
+    const auto line = message.dump() + "\n";
+
+#ifdef MSG_NOSIGNAL
+    constexpr int flags = MSG_NOSIGNAL;
+#else
+    constexpr int flags = 0;
+#endif
+
+    std::size_t sent = 0;
+    while (sent < line.size()) {
+        const auto n = ::send(m_fd, line.data() + sent, line.size() - sent, flags);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+
+    return true;
+}
+
+auto Connection::receive() -> bool {
+    char buffer[4096];
+
+    while (true) {
+        const auto n = recv(m_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n > 0) {
+            m_buffer.append(buffer, static_cast<std::size_t>(n));
+            if (static_cast<std::size_t>(n) < sizeof(buffer)) {
+                return true;
+            }
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && errno == EAGAIN) {
+            return true;
+        } else {
+            return false;
+        }
+    }
+}
+
+auto Connection::next_message() -> std::optional<nlohmann::json> {
+    while (true) {
+        const auto newline = m_buffer.find('\n');
+        if (newline == std::string::npos) {
+            return std::nullopt;
+        }
+
+        const auto line = m_buffer.substr(0, newline);
+        m_buffer.erase(0, newline + 1);
+
+        auto message = nlohmann::json::parse(line, nullptr, false);
+        if (message.is_object()) {
+            return message;
+        }
+    }
+}
+
+auto Connection::shutdown() noexcept -> void {
+    ::shutdown(m_fd, SHUT_RDWR);
+}
+
+auto listen_tcp(const std::string &host, const int port) -> int {
+    auto *const addresses = resolve(host, port, true);
+
+    auto err = 0;
+    for (auto *address = addresses; address; address = address->ai_next) {
+        const auto fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0) {
+            err = errno;
+            continue;
+        }
+
+        // Don't wait for connections from an earlier match to time out before reusing the port
+        const int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        if (bind(fd, address->ai_addr, address->ai_addrlen) == 0 && listen(fd, 16) == 0) {
+            freeaddrinfo(addresses);
+            return fd;
+        }
+
+        err = errno;
+        close(fd);
+    }
+
+    freeaddrinfo(addresses);
+    throw std::system_error(err, std::generic_category(), "Could not listen on " + host + ":" + std::to_string(port));
+}
+
+auto local_port(const int fd) -> int {
+    sockaddr_storage addr = {};
+    socklen_t size = sizeof(addr);
+    if (getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &size) != 0) {
+        throw std::system_error(errno, std::generic_category(), "getsockname");
+    }
+
+    if (addr.ss_family == AF_INET6) {
+        return ntohs(reinterpret_cast<const sockaddr_in6 *>(&addr)->sin6_port);
+    }
+    return ntohs(reinterpret_cast<const sockaddr_in *>(&addr)->sin_port);
+}
+
+#else
+
+Connection::Connection(const int fd) noexcept : m_fd(fd) {
+}
+
+auto Connection::connect(const std::string &, const int) -> Connection {
+    throw std::runtime_error("Distributed matches aren't supported on Windows");
+}
+
+Connection::Connection(Connection &&other) noexcept
+    : m_fd(std::exchange(other.m_fd, -1)), m_buffer(std::move(other.m_buffer)) {
+}
+
+Connection &Connection::operator=(Connection &&other) noexcept {
+    m_fd = std::exchange(other.m_fd, -1);
+    m_buffer = std::move(other.m_buffer);
+    return *this;
+}
+
+Connection::~Connection() {
+}
+
+auto Connection::send(const nlohmann::json &) -> bool {
+    return false;
+}
+
+auto Connection::receive() -> bool {
+    return false;
+}
+
+auto Connection::next_message() -> std::optional<nlohmann::json> {
+    return std::nullopt;
+}
+
+auto Connection::shutdown() noexcept -> void {
+}
+
+auto listen_tcp(const std::string &, const int) -> int {
+    throw std::runtime_error("Distributed matches aren't supported on Windows");
+}
+
+auto local_port(const int) -> int {
+    return 0;
+}
+
+#endif
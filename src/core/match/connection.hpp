@@ -0,0 +1,56 @@
+#ifndef MATCH_CONNECTION_HPP
+#define MATCH_CONNECTION_HPP
+
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+
+// A TCP connection carrying one JSON message per line, for a coordinator and its nodes to talk over
+// Not supported on Windows
+class Connection {
+   public:
+    // Takes ownership of a socket that's already connected
+    [[nodiscard]] explicit Connection(const int fd) noexcept;
+
+    // Throws if we can't connect
+    [[nodiscard]] static auto connect(const std::string &host, const int port) -> Connection;
+
+    Connection(const Connection &) = delete;
+
+    Connection &operator=(const Connection &) = delete;
+
+    [[nodiscard]] Connection(Connection &&other) noexcept;
+
+    Connection &operator=(Connection &&other) noexcept;
+
+    ~Connection();
+
+    [[nodiscard]] auto fd() const noexcept -> int {
+        return m_fd;
+    }
+
+    // Blocks until the whole message is sent, returns false if the other end has gone away
+    auto send(const nlohmann::json &message) -> bool;
+
+    // Read whatever has arrived without waiting for more, returns false once the other end has closed the connection
+    [[nodiscard]] auto receive() -> bool;
+
+    // The next whole message received, lines that aren't JSON objects are skipped
+    [[nodiscard]] auto next_message() -> std::optional<nlohmann::json>;
+
+    // Wakes anyone waiting to read from the connection, who'll find it closed
+    auto shutdown() noexcept -> void;
+
+   private:
+    int m_fd = -1;
+    std::string m_buffer;
+};
+
+// A socket listening for connections on the given address and port, any free port if it's 0
+// Throws if it can't be opened
+[[nodiscard]] auto listen_tcp(const std::string &host, const int port) -> int;
+
+// The port a socket is bound to
+[[nodiscard]] auto local_port(const int fd) -> int;
+
+#endif
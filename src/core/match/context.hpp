@@ -0,0 +1,22 @@
+#ifndef MATCH_CONTEXT_HPP
+#define MATCH_CONTEXT_HPP
+
+#include <vector>
+#include "../tournament/generator.hpp"
+#include "callbacks.hpp"
+
+class Settings;
+class OpeningBook;
+
+// Everything about a match that doesn't change once it starts
+// Owned by run() and shared by reference between every thread, so nothing here is copied per thread or per game
+struct MatchContext {
+    const Settings &settings;
+    const OpeningBook &openings;
+    const TournamentGenerator &game_generator;
+    const Callbacks &callbacks;
+    // The cores each game slot's engines are pinned to, empty if they aren't
+    const std::vector<std::vector<int>> &slot_cores;
+};
+
+#endif
@@ -0,0 +1,298 @@
+#include "coordinator.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+#include "../opening_book.hpp"
+#include "../play.hpp"
+#include "game_writer.hpp"
+#include "protocol.hpp"
+#include "settings.hpp"
+#include "worker.hpp"
+// Tournaments
+#include "../tournament/create.hpp"
+#include "../tournament/resume.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// How often to check for leases running out when nothing else is happening
+constexpr int poll_ms = 1000;
+// How long a node should wait before asking again when every game has been handed out
+constexpr int retry_ms = 1000;
+// The most games a node can hold at once
+constexpr std::size_t max_batch = 64;
+
+[[nodiscard]] auto engine_names(const Settings &settings) -> std::vector<std::string> {
+    std::vector<std::string> names;
+    for (const auto &engine : settings.engines) {
+        names.emplace_back(engine.name);
+    }
+    return names;
+}
+
+// When a node's games are given to someone else if we don't hear from it
+[[nodiscard]] auto lease_expiry(const Settings &settings) -> std::chrono::steady_clock::time_point {
+    return std::chrono::steady_clock::now() + std::chrono::milliseconds(settings.distributed.lease_timeout);
+}
+
+}  // namespace
+
+Coordinator::Coordinator(const Settings &settings,
+                         const OpeningBook &openings,
+                         Checkpoint checkpoint,
+                         const Callbacks &callbacks)
+    : m_settings(settings),
+      m_openings(openings),
+      m_callbacks(callbacks),
+      m_checkpoint(std::move(checkpoint)),
+      m_names(engine_names(settings)),
+      m_playing_settings(playing_settings(settings)),
+      m_generator(
+          make_generator(settings.tournament_type, settings.engines.size(), settings.num_games, openings.size())),
+      m_remaining(std::make_shared<ResumeGenerator>(m_generator, m_checkpoint.finished_below, m_checkpoint.finished)),
+      m_tally(m_names, 1, m_generator->expected()),
+      m_leases(m_remaining->expected()),
+      m_context{settings, openings, *m_remaining, callbacks, m_slot_cores} {
+    // A checkpoint from a different match would give nonsense results
+    check_checkpoint(m_checkpoint, m_names, settings.tournament_type, openings, m_generator->expected());
+    m_tally.restore(m_checkpoint.results, m_checkpoint.half_pairs);
+
+    // Games are written as they come in, just like playing them here
+    if ((settings.pgn.enabled && !settings.pgn.path.empty()) ||
+        (settings.binary.enabled && !settings.binary.path.empty()) || settings.checkpoint.enabled) {
+        m_game_writer = std::make_unique<GameWriter>(settings, m_names, m_checkpoint);
+    }
+
+    m_listen = listen_tcp(settings.distributed.host, settings.distributed.port);
+}
+
+Coordinator::~Coordinator() {
+#ifndef _WIN32
+    if (m_listen >= 0) {
+        close(m_listen);
+    }
+#endif
+}
+
+auto Coordinator::port() const -> int {
+    return local_port(m_listen);
+}
+
+#ifndef _WIN32
+
+auto Coordinator::run() -> Results {
+    // Don't hand anything out if the SPRT had already finished
+    if (is_sprt_stop(m_settings, m_tally.snapshot())) {
+        m_stop.finish();
+    }
+
+    // Games that are still out when the match is stopping are waited for, unless they're being abandoned
+    while (!m_leases.is_finished() && !m_stop.is_aborted() && !(m_stop.is_finishing() && m_leases.num_leased() == 0)) {
+        const auto now = std::chrono::steady_clock::now();
+        if (const auto num_returned = m_leases.expire(now); num_returned > 0) {
+            std::cout << num_returned << " games given back by a node that went quiet\n";
+        }
+
+        auto timeout = poll_ms;
+        if (const auto expiry = m_leases.next_expiry()) {
+            const auto until = std::chrono::ceil<std::chrono::milliseconds>(*expiry - now).count();
+            timeout = static_cast<int>(std::clamp<std::int64_t>(until, 0, poll_ms));
+        }
+
+        std::vector<pollfd> fds;
+        fds.push_back({m_listen, POLLIN, 0});
+        for (const auto &node : m_nodes) {
+            fds.push_back({node.connection.fd(), POLLIN, 0});
+        }
+
+        if (poll(fds.data(), fds.size(), timeout) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "poll");
+        }
+
+        // Only the nodes that were polled, new ones are added after them
+        const auto num_polled = m_nodes.size();
+
+        if (fds[0].revents & POLLIN) {
+            const auto client = accept(m_listen, nullptr, nullptr);
+            if (client >= 0) {
+                m_nodes.push_back(Node{m_next_node++, Connection(client), false});
+            }
+        }
+
+        std::vector<std::size_t> gone;
+        for (std::size_t i = 0; i < num_polled; ++i) {
+            if (!fds[i + 1].revents) {
+                continue;
+            }
+
+            auto &node = m_nodes[i];
+            auto alive = node.connection.receive();
+            while (const auto message = node.connection.next_message()) {
+                if (!handle(node, *message)) {
+                    alive = false;
+                    break;
+                }
+            }
+
+            if (!alive) {
+                gone.push_back(i);
+            }
+        }
+
+        // Whatever the nodes that left were playing goes to someone else
+        for (auto iter = gone.rbegin(); iter != gone.rend(); ++iter) {
+            const auto num_returned = m_leases.release(m_nodes[*iter].id);
+            if (num_returned > 0) {
+                std::cout << num_returned << " games given back by node " << m_nodes[*iter].id
+                          << " when it disconnected\n";
+            }
+            m_nodes.erase(m_nodes.begin() + static_cast<std::ptrdiff_t>(*iter));
+        }
+    }
+
+    // Let everyone still connected know there's nothing more coming
+    for (auto &node : m_nodes) {
+        node.connection.send({{"type", "stop"}, {"abort", m_stop.is_aborted()}});
+    }
+    m_nodes.clear();
+
+    // Make sure every game has been written
+    if (m_game_writer) {
+        m_game_writer->stop();
+    }
+
+    const auto results = m_tally.snapshot();
+
+    assert(results.games_started == results.games_played);
+    assert(results.black_wins + results.white_wins + results.draws == results.games_played);
+
+    return results;
+}
+
+#else
+
+auto Coordinator::run() -> Results {
+    throw std::runtime_error("Distributed matches aren't supported on Windows");
+}
+
+#endif
+
+auto Coordinator::handle(Node &node, const nlohmann::json &message) -> bool {
+    const auto type = message.value("type", "");
+
+    // Anything at all means the node is still there
+    m_leases.renew(node.id, lease_expiry(m_settings));
+
+    if (type == "hello") {
+        // Different engines would mean different games, and results credited to the wrong engines
+        if (message.value("engines", std::vector<std::string>{}) != m_names) {
+            node.connection.send({{"type", "error"}, {"message", "Engines don't match the coordinator's"}});
+            return false;
+        }
+
+        // Nodes playing with a different time control or adjudication would skew the results
+        const auto theirs = message.value("settings", nlohmann::json());
+        if (const auto mismatch = playing_settings_mismatch(m_playing_settings, theirs)) {
+            const auto error = "Settings for " + *mismatch + " don't match the coordinator's";
+            node.connection.send({{"type", "error"}, {"message", error}});
+            return false;
+        }
+
+        node.said_hello = true;
+        if (m_settings.verbose) {
+            std::cout << "Node " << node.id << " connected\n";
+        }
+        const auto ping = std::max(1, m_settings.distributed.lease_timeout / 4);
+        return node.connection.send({{"type", "welcome"}, {"ping", ping}});
+    } else if (!node.said_hello) {
+        node.connection.send({{"type", "error"}, {"message", "Expected hello"}});
+        return false;
+    } else if (type == "lease") {
+        return lease(node, message);
+    } else if (type == "result") {
+        record(message);
+    }
+
+    return true;
+}
+
+auto Coordinator::lease(Node &node, const nlohmann::json &message) -> bool {
+    const auto seq = message.value("seq", 0);
+    const auto count = std::clamp<std::size_t>(message.value("count", std::size_t{1}), 1, max_batch);
+
+    // Once the match is stopping, only the games already out are finished
+    if (m_stop.is_finishing()) {
+        return node.connection.send({{"type", "done"}, {"seq", seq}});
+    }
+
+    const auto leased = m_leases.lease(node.id, count, lease_expiry(m_settings));
+
+    if (leased.empty()) {
+        // Games still out might be given back
+        if (m_leases.num_leased() > 0) {
+            return node.connection.send({{"type", "wait"}, {"seq", seq}, {"ms", retry_ms}});
+        }
+        return node.connection.send({{"type", "done"}, {"seq", seq}});
+    }
+
+    auto games = nlohmann::json::array();
+    for (const auto idx : leased) {
+        const auto game_info = m_remaining->game_at(idx);
+        games.push_back({
+            {"idx", idx},
+            {"id", game_info.id},
+            {"opening", m_openings.position(game_info.idx_opening).get_fen()},
+            {"player1", game_info.idx_player1},
+            {"player2", game_info.idx_player2},
+        });
+        m_callbacks.on_game_started(0, m_names[game_info.idx_player1], m_names[game_info.idx_player2]);
+    }
+
+    return node.connection.send({{"type", "games"}, {"seq", seq}, {"games", games}});
+}
+
+auto Coordinator::record(const nlohmann::json &message) -> void {
+    const auto idx = message.value("idx", m_remaining->expected());
+    if (idx >= m_remaining->expected()) {
+        return;
+    }
+
+    const auto game_info = m_remaining->game_at(idx);
+    if (message.value("id", game_info.id + 1) != game_info.id) {
+        return;
+    }
+
+    GameThingy game_data;
+    try {
+        game_data = game_from_json(message.at("game"));
+    } catch (const std::exception &e) {
+        std::cerr << "Bad result for game " << game_info.id << ": " << e.what() << "\n";
+        return;
+    }
+
+    // Abandoned games are played again by whoever gets them next, and later results for a game that was given to
+    // someone else are duplicates
+    if (game_data.reason == ResultReason::Aborted || !m_leases.complete(idx)) {
+        return;
+    }
+
+    const auto game = GameSettings{m_openings.position(game_info.idx_opening),
+                                   m_settings.engines[game_info.idx_player1],
+                                   m_settings.engines[game_info.idx_player2]};
+
+    m_tally.started(0);
+    record_game(0, m_context, game_info, game, game_data, m_tally, m_stop, m_game_writer.get());
+}
@@ -0,0 +1,79 @@
+#ifndef MATCH_COORDINATOR_HPP
+#define MATCH_COORDINATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "callbacks.hpp"
+#include "checkpoint.hpp"
+#include "connection.hpp"
+#include "context.hpp"
+#include "lease.hpp"
+#include "results.hpp"
+#include "stop.hpp"
+#include "tally.hpp"
+
+class Settings;
+class OpeningBook;
+class TournamentGenerator;
+class GameWriter;
+
+// Share a match between machines, handing out games to nodes that connect over TCP and play them with their own
+// engines, then recording the results as if they'd been played here
+// Everything happens on the calling thread, waiting on every node at once
+// A node that disconnects or goes quiet for longer than the lease timeout has its games given to the others
+class Coordinator {
+   public:
+    // Starts listening straight away, so nodes can connect before run() is called
+    [[nodiscard]] Coordinator(const Settings &settings,
+                              const OpeningBook &openings,
+                              Checkpoint checkpoint,
+                              const Callbacks &callbacks);
+
+    ~Coordinator();
+
+    Coordinator(const Coordinator &) = delete;
+
+    Coordinator &operator=(const Coordinator &) = delete;
+
+    // Where nodes should connect, which is useful when the settings asked for any free port
+    [[nodiscard]] auto port() const -> int;
+
+    // Hand out games until they've all been played, or the SPRT ends the match
+    [[nodiscard]] auto run() -> Results;
+
+   private:
+    struct Node {
+        std::size_t id = 0;
+        Connection connection;
+        bool said_hello = false;
+    };
+
+    // Returns false if the node should be disconnected
+    [[nodiscard]] auto handle(Node &node, const nlohmann::json &message) -> bool;
+
+    [[nodiscard]] auto lease(Node &node, const nlohmann::json &message) -> bool;
+
+    auto record(const nlohmann::json &message) -> void;
+
+    const Settings &m_settings;
+    const OpeningBook &m_openings;
+    const Callbacks &m_callbacks;
+    Checkpoint m_checkpoint;
+    std::vector<std::string> m_names;
+    nlohmann::json m_playing_settings;
+    std::shared_ptr<TournamentGenerator> m_generator;
+    std::shared_ptr<TournamentGenerator> m_remaining;
+    ResultsTally m_tally;
+    LeaseTable m_leases;
+    std::vector<std::vector<int>> m_slot_cores;
+    MatchContext m_context;
+    StopToken m_stop;
+    std::unique_ptr<GameWriter> m_game_writer;
+    int m_listen = -1;
+    std::vector<Node> m_nodes;
+    std::size_t m_next_node = 0;
+};
+
+#endif
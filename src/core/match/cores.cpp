@@ -0,0 +1,232 @@
+#include "cores.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <utils.hpp>
+#include "settings.hpp"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace {
+
+// The value of an engine option as a number, ignoring the case of its name
+[[nodiscard]] auto option_value(const EngineSettings &engine, const std::string_view option, const int fallback)
+    -> int {
+    for (const auto &[name, value] : engine.options) {
+        auto lower = name;
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](const unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+
+        if (lower == option) {
+            try {
+                return std::stoi(value);
+            } catch (...) {
+                return fallback;
+            }
+        }
+    }
+
+    return fallback;
+}
+
+}  // namespace
+
+auto available_memory() -> std::int64_t {
+#ifndef _WIN32
+    const auto pages = sysconf(_SC_PHYS_PAGES);
+    const auto page_size = sysconf(_SC_PAGE_SIZE);
+    if (pages > 0 && page_size > 0) {
+        return static_cast<std::int64_t>(pages) * page_size / (1024 * 1024);
+    }
+#endif
+    return 0;
+}
+
+auto engine_threads(const EngineSettings &engine) -> int {
+    return std::max(1, option_value(engine, "threads", 1));
+}
+
+auto engine_hash(const EngineSettings &engine) -> int {
+    return std::max(0, option_value(engine, "hash", 0));
+}
+
+auto available_cores() -> int {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        return std::max(1, CPU_COUNT(&set));
+    }
+#endif
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+auto game_cores(const EngineSettings &engine1, const EngineSettings &engine2) -> int {
+    const auto threads1 = engine_threads(engine1);
+    const auto threads2 = engine_threads(engine2);
+    return engine1.ponder || engine2.ponder ? threads1 + threads2 : std::max(threads1, threads2);
+}
+
+auto cores_per_game(const Settings &settings) -> int {
+    auto most = 1;
+
+    for (std::size_t i = 0; i < settings.engines.size(); ++i) {
+        for (std::size_t j = i + 1; j < settings.engines.size(); ++j) {
+            most = std::max(most, game_cores(settings.engines[i], settings.engines[j]));
+        }
+    }
+
+    return most;
+}
+
+auto max_concurrency(const Settings &settings) -> int {
+    return std::max(1, available_cores() / cores_per_game(settings));
+}
+
+auto parse_cpulist(const std::string_view list) -> std::vector<int> {
+    std::vector<int> cores;
+
+    for (const auto &range : utils::split(list, ",")) {
+        const auto dash = range.find('-');
+        try {
+            const auto first = std::stoi(std::string(range.substr(0, dash)));
+            const auto last = dash == std::string_view::npos ? first : std::stoi(std::string(range.substr(dash + 1)));
+            for (auto core = first; core <= last; ++core) {
+                cores.push_back(core);
+            }
+        } catch (...) {
+        }
+    }
+
+    return cores;
+}
+
+auto numa_cores() -> std::vector<std::vector<int>> {
+    std::set<int> allowed;
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int core = 0; core < CPU_SETSIZE; ++core) {
+            if (CPU_ISSET(core, &set)) {
+                allowed.insert(core);
+            }
+        }
+    }
+#endif
+
+    if (allowed.empty()) {
+        for (int core = 0; core < available_cores(); ++core) {
+            allowed.insert(core);
+        }
+    }
+
+    // Nodes are listed in order, and we only want the cores we can use on each
+    std::map<int, std::vector<int>> by_node;
+    std::error_code ec;
+    auto iter = std::filesystem::directory_iterator("/sys/devices/system/node", ec);
+    for (; !ec && iter != std::filesystem::directory_iterator(); iter.increment(ec)) {
+        const auto name = iter->path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+            !std::all_of(name.begin() + 4, name.end(), [](const unsigned char c) {
+                return std::isdigit(c);
+            })) {
+            continue;
+        }
+
+        std::ifstream file(iter->path() / "cpulist");
+        std::string line;
+        std::getline(file, line);
+
+        auto &cores = by_node[std::stoi(name.substr(4))];
+        for (const auto core : parse_cpulist(line)) {
+            if (allowed.erase(core)) {
+                cores.push_back(core);
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> nodes;
+    for (auto &[node, cores] : by_node) {
+        if (!cores.empty()) {
+            nodes.push_back(std::move(cores));
+        }
+    }
+
+    // Cores the system didn't tell us the node of, or all of them if there's no NUMA information
+    if (!allowed.empty()) {
+        nodes.emplace_back(allowed.begin(), allowed.end());
+    }
+
+    return nodes;
+}
+
+auto layout_cores(const std::vector<std::vector<int>> &nodes, const int num_slots, const int cores_per_slot)
+    -> std::vector<std::vector<int>> {
+    const auto wanted = static_cast<std::size_t>(std::max(0, num_slots));
+    const auto size = static_cast<std::size_t>(std::max(1, cores_per_slot));
+    std::vector<std::vector<int>> slots;
+    std::vector<int> leftover;
+
+    // Fill each node with as many whole slots as fit
+    for (const auto &cores : nodes) {
+        std::size_t i = 0;
+        for (; i + size <= cores.size() && slots.size() < wanted; i += size) {
+            slots.emplace_back(cores.begin() + i, cores.begin() + i + size);
+        }
+        leftover.insert(leftover.end(), cores.begin() + i, cores.end());
+    }
+
+    // Then make slots out of what's left, even if they cross nodes
+    std::size_t i = 0;
+    for (; i + size <= leftover.size() && slots.size() < wanted; i += size) {
+        slots.emplace_back(leftover.begin() + i, leftover.begin() + i + size);
+    }
+
+    // Slots bigger than the whole machine get everything
+    if (slots.empty()) {
+        if (leftover.empty()) {
+            return {};
+        }
+        slots.push_back(leftover);
+    }
+
+    // Start again from the first slot for any that didn't fit
+    const auto num_unique = slots.size();
+    while (slots.size() < wanted) {
+        slots.push_back(slots[slots.size() - num_unique]);
+    }
+
+    return slots;
+}
+
+auto split_cores(const std::vector<int> &cores, const EngineSettings &engine1, const EngineSettings &engine2)
+    -> std::pair<std::vector<int>, std::vector<int>> {
+    if (cores.empty() || (!engine1.ponder && !engine2.ponder)) {
+        return {cores, cores};
+    }
+
+    const auto threads1 = static_cast<std::size_t>(engine_threads(engine1));
+    const auto threads2 = static_cast<std::size_t>(engine_threads(engine2));
+
+    // Share if the slot was laid out for fewer cores than this pair needs
+    if (threads1 + threads2 > cores.size()) {
+        return {cores, cores};
+    }
+
+    return {std::vector<int>(cores.begin(), cores.begin() + threads1),
+            std::vector<int>(cores.begin() + threads1, cores.begin() + threads1 + threads2)};
+}
@@ -0,0 +1,53 @@
+#ifndef MATCH_CORES_HPP
+#define MATCH_CORES_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class Settings;
+class EngineSettings;
+
+// The number of cores we're allowed to run on, which can be fewer than the machine has
+[[nodiscard]] auto available_cores() -> int;
+
+// The machine's physical memory in megabytes, or 0 if we can't tell
+[[nodiscard]] auto available_memory() -> std::int64_t;
+
+// How many threads an engine searches with, going by its "threads" option
+[[nodiscard]] auto engine_threads(const EngineSettings &engine) -> int;
+
+// How many megabytes an engine's hash table takes, going by its "hash" option
+[[nodiscard]] auto engine_hash(const EngineSettings &engine) -> int;
+
+// How many cores a game between these two engines can keep busy at once
+[[nodiscard]] auto game_cores(const EngineSettings &engine1, const EngineSettings &engine2) -> int;
+
+// The most cores a single game can keep busy at once, out of any two engines that could meet
+// Engines search with as many threads as their "threads" option says, and pondering lets both engines in a game
+// search at the same time
+[[nodiscard]] auto cores_per_game(const Settings &settings) -> int;
+
+// How many games can be played at once without running more searches than there are cores
+[[nodiscard]] auto max_concurrency(const Settings &settings) -> int;
+
+// Read a list of cores in the kernel's format, such as "0-3,8-11"
+[[nodiscard]] auto parse_cpulist(const std::string_view list) -> std::vector<int>;
+
+// The cores we're allowed to run on, grouped by NUMA node
+[[nodiscard]] auto numa_cores() -> std::vector<std::vector<int>>;
+
+// Give each game slot its own cores, keeping a slot's cores on the same NUMA node where possible
+// If there aren't enough cores to go round, the slots that don't fit share with the first ones
+[[nodiscard]] auto layout_cores(const std::vector<std::vector<int>> &nodes,
+                                const int num_slots,
+                                const int cores_per_slot) -> std::vector<std::vector<int>>;
+
+// The cores each engine in a game gets out of those belonging to its slot
+// Pondering engines can search at the same time so they're kept apart, otherwise they take turns on the same cores
+[[nodiscard]] auto split_cores(const std::vector<int> &cores,
+                               const EngineSettings &engine1,
+                               const EngineSettings &engine2) -> std::pair<std::vector<int>, std::vector<int>>;
+
+#endif
@@ -0,0 +1,516 @@
+#include "event_loop.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include "../game_state.hpp"
+#include "../opening_book.hpp"
+#include "../play.hpp"
+#include "resources.hpp"
+#include "settings.hpp"
+#include "stop.hpp"
+#include "tally.hpp"
+#include "worker.hpp"
+// Engines
+#include "../engine/builtin/builtin.hpp"
+#include "../engine/engine.hpp"
+#include "../engine/pool.hpp"
+#include "../engine/process.hpp"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace {
+
+// How often to look for room in the budget while a game is waiting for it
+constexpr int budget_poll_ms = 10;
+
+// How often to check whether the match has been aborted by another thread
+constexpr int stop_poll_ms = 20;
+
+struct GameSlot {
+    enum class Stage : int
+    {
+        // Not playing a game
+        Idle = 0,
+        // Holding on to a game until there's room in the budget to start it
+        Waiting,
+        // Waiting for both engines to be ready for a new game
+        Starting,
+        // Nothing to wait for, ready to ask for the next move
+        Playing,
+        // Waiting for the engine to move to be ready
+        Ready,
+        // Waiting for the engine to move to reply with a move
+        Go,
+    };
+
+    std::size_t id = 0;
+    Stage stage = Stage::Idle;
+    GameInfo game_info;
+    GameResources resources;
+    std::optional<GameSettings> game;
+    std::optional<GameState> state;
+    std::array<std::shared_ptr<Engine>, 2> engines;
+    // Engines we can wait on, builtin engines are asked for moves directly
+    std::array<AsyncEngine *, 2> async = {nullptr, nullptr};
+    std::array<bool, 2> pending = {false, false};
+    std::chrono::steady_clock::time_point t0;
+    // When to stop waiting for the engine to move
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+};
+
+class EventLoop {
+   public:
+    [[nodiscard]] EventLoop(const std::size_t first_id,
+                            const std::size_t num_games,
+                            const MatchContext &context,
+                            std::atomic<std::size_t> &next_game,
+                            StopToken &stop,
+                            EnginePool &engine_pool,
+                            ResultsTally &tally,
+                            ResourceBudget *budget,
+                            GameWriter *game_writer)
+        : m_context(context),
+          m_next_game(next_game),
+          m_stop(stop),
+          m_engine_pool(engine_pool),
+          m_tally(tally),
+          m_budget(budget),
+          m_game_writer(game_writer),
+          m_slots(num_games),
+          m_epoll(epoll_create1(EPOLL_CLOEXEC)) {
+        if (m_epoll < 0) {
+            throw std::system_error(errno, std::generic_category(), "epoll_create1");
+        }
+
+        for (std::size_t i = 0; i < m_slots.size(); ++i) {
+            m_slots[i].id = first_id + i;
+        }
+    }
+
+    ~EventLoop() {
+        close(m_epoll);
+    }
+
+    auto run() -> void {
+        std::vector<epoll_event> events(2 * m_slots.size());
+
+        while (true) {
+            // Abandon every game as soon as we're told to, however far along they are
+            if (m_stop.is_aborted()) {
+                abort_games();
+            }
+
+            // Keep every slot busy while there are games left to play
+            // Games between builtin engines are over before start_game() returns, so keep going
+            auto is_busy = false;
+            auto is_waiting = false;
+            for (auto &slot : m_slots) {
+                while (is_startable(slot) && !m_stop.is_aborted() && start_game(slot)) {
+                    update(slot);
+                }
+
+                is_busy |= slot.stage != GameSlot::Stage::Idle;
+                is_waiting |= slot.stage == GameSlot::Stage::Waiting;
+            }
+
+            if (!is_busy) {
+                return;
+            }
+
+            // Games finishing in other threads don't wake us up, so check back for room in the budget
+            auto timeout = next_timeout();
+            if (is_waiting && (timeout < 0 || timeout > budget_poll_ms)) {
+                timeout = budget_poll_ms;
+            }
+            if (m_context.settings.sprt.abort && (timeout < 0 || timeout > stop_poll_ms)) {
+                timeout = stop_poll_ms;
+            }
+            const auto num_events = epoll_wait(m_epoll, events.data(), static_cast<int>(events.size()), timeout);
+
+            if (num_events < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "epoll_wait");
+            }
+
+            for (int i = 0; i < num_events; ++i) {
+                auto &slot = m_slots[events[i].data.u64 / 2];
+                const auto side = events[i].data.u64 % 2;
+
+                // The game might have ended while handling an earlier event
+                if (slot.stage == GameSlot::Stage::Idle || slot.stage == GameSlot::Stage::Waiting) {
+                    continue;
+                }
+
+                try {
+                    if (!slot.async[side]->read_available()) {
+                        throw std::runtime_error("Engine closed its output");
+                    }
+
+                    // Throw away anything we weren't waiting for
+                    if (!is_waiting_on(slot, side)) {
+                        while (slot.async[side]->next_line()) {
+                        }
+                    }
+                } catch (...) {
+                    crash(slot);
+                    continue;
+                }
+
+                update(slot);
+            }
+
+            check_deadlines();
+        }
+    }
+
+   private:
+    [[nodiscard]] static auto is_startable(const GameSlot &slot) -> bool {
+        return slot.stage == GameSlot::Stage::Idle || slot.stage == GameSlot::Stage::Waiting;
+    }
+
+    [[nodiscard]] static auto side_to_move(const GameSlot &slot) -> std::size_t {
+        return slot.state->turn() == libataxx::Side::Black ? 0 : 1;
+    }
+
+    [[nodiscard]] static auto is_waiting_on(const GameSlot &slot, const std::size_t side) -> bool {
+        switch (slot.stage) {
+            case GameSlot::Stage::Starting:
+                return slot.pending[side];
+            case GameSlot::Stage::Ready:
+            case GameSlot::Stage::Go:
+                return side == side_to_move(slot);
+            default:
+                return false;
+        }
+    }
+
+    // How many milliseconds until the next deadline, or -1 if there isn't one
+    [[nodiscard]] auto next_timeout() const -> int {
+        std::optional<std::chrono::steady_clock::time_point> first;
+
+        for (const auto &slot : m_slots) {
+            if (slot.deadline && (!first || *slot.deadline < *first)) {
+                first = slot.deadline;
+            }
+        }
+
+        if (!first) {
+            return -1;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*first - now).count();
+        return static_cast<int>(std::max<decltype(remaining)>(remaining, 0));
+    }
+
+    // Engines that didn't reply in time lose, and get replaced
+    auto check_deadlines() -> void {
+        const auto now = std::chrono::steady_clock::now();
+
+        for (auto &slot : m_slots) {
+            if (slot.stage == GameSlot::Stage::Idle || !slot.deadline || *slot.deadline > now) {
+                continue;
+            }
+
+            slot.async[side_to_move(slot)]->abandon();
+            slot.state->timeout();
+            finish_game(slot, true);
+        }
+    }
+
+    auto start_deadline(GameSlot &slot) -> void {
+        const auto time_limit = slot.state->time_limit();
+        if (time_limit) {
+            slot.deadline = std::chrono::steady_clock::now() + *time_limit;
+        } else {
+            slot.deadline.reset();
+        }
+    }
+
+    [[nodiscard]] auto start_game(GameSlot &slot) -> bool {
+        if (slot.stage == GameSlot::Stage::Idle) {
+            // Return if we're out of things to do
+            const auto claimed = claim_game(m_context, m_next_game, m_stop);
+            if (!claimed) {
+                return false;
+            }
+
+            slot.game_info = *claimed;
+            slot.resources = game_resources(m_context.settings.engines[slot.game_info.idx_player1],
+                                            m_context.settings.engines[slot.game_info.idx_player2]);
+            slot.stage = GameSlot::Stage::Waiting;
+        }
+
+        // Keep the game until the games already running make room for it
+        if (m_budget && !m_budget->try_acquire(slot.resources)) {
+            return false;
+        }
+
+        m_tally.started(slot.id);
+
+        slot.game.emplace(m_context.openings.position(slot.game_info.idx_opening),
+                          m_context.settings.engines[slot.game_info.idx_player1],
+                          m_context.settings.engines[slot.game_info.idx_player2]);
+
+        m_context.callbacks.on_game_started(0, slot.game->engine1.name, slot.game->engine2.name);
+
+        slot.engines[0] = get_engine(m_engine_pool, slot.game->engine1, m_context.callbacks);
+        slot.engines[1] = get_engine(m_engine_pool, slot.game->engine2, m_context.callbacks);
+        pin_engines(m_context, slot.id, *slot.game, *slot.engines[0], *slot.engines[1]);
+        slot.state.emplace(m_context.settings.adjudication, *slot.game);
+        slot.stage = GameSlot::Stage::Starting;
+
+        try {
+            for (std::size_t side = 0; side < 2; ++side) {
+                auto &engine = slot.engines[side];
+                slot.async[side] = dynamic_cast<AsyncEngine *>(engine.get());
+                slot.pending[side] = slot.async[side] != nullptr;
+
+                engine->newgame();
+
+                if (slot.async[side]) {
+                    epoll_event event;
+                    event.events = EPOLLIN;
+                    event.data.u64 = 2 * static_cast<std::size_t>(&slot - m_slots.data()) + side;
+                    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, slot.async[side]->native_handle(), &event) < 0) {
+                        throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+                    }
+
+                    slot.async[side]->request_isready();
+                    slot.async[side]->flush();
+                } else {
+                    engine->isready();
+                }
+            }
+        } catch (...) {
+            crash(slot);
+        }
+
+        return true;
+    }
+
+    // Make as much progress in the game as we can without waiting on an engine
+    auto update(GameSlot &slot) -> void {
+        try {
+            while (slot.stage != GameSlot::Stage::Idle) {
+                if (slot.stage == GameSlot::Stage::Starting && !slot.pending[0] && !slot.pending[1]) {
+                    slot.stage = GameSlot::Stage::Playing;
+                }
+
+                if (slot.stage == GameSlot::Stage::Playing) {
+                    play_move(slot);
+                } else if (!handle_line(slot)) {
+                    return;
+                }
+            }
+        } catch (...) {
+            // Not something the engines did
+            if (slot.stage == GameSlot::Stage::Idle) {
+                throw;
+            }
+            crash(slot);
+        }
+    }
+
+    // Deal with the next line of output we've been waiting for, if there is one
+    [[nodiscard]] auto handle_line(GameSlot &slot) -> bool {
+        for (std::size_t side = 0; side < 2; ++side) {
+            if (!is_waiting_on(slot, side)) {
+                continue;
+            }
+
+            const auto line = slot.async[side]->next_line();
+            if (!line) {
+                continue;
+            }
+
+            on_line(slot, side, *line);
+            return true;
+        }
+
+        return false;
+    }
+
+    auto on_line(GameSlot &slot, const std::size_t side, const std::string_view line) -> void {
+        auto engine = slot.async[side];
+
+        switch (slot.stage) {
+            case GameSlot::Stage::Starting:
+                if (engine->is_isready_reply(line)) {
+                    slot.pending[side] = false;
+                }
+                break;
+            case GameSlot::Stage::Ready:
+                if (engine->is_isready_reply(line)) {
+                    start_search(slot, engine);
+                }
+                break;
+            case GameSlot::Stage::Go:
+                if (const auto movestr = engine->parse_go_reply(line)) {
+                    const auto t1 = std::chrono::steady_clock::now();
+                    const auto first_reply = engine->first_reply_time().value_or(t1);
+                    slot.deadline.reset();
+                    slot.state->apply(*movestr,
+                                      std::chrono::duration_cast<std::chrono::microseconds>(t1 - slot.t0),
+                                      std::chrono::duration_cast<std::chrono::microseconds>(first_reply - slot.t0));
+                    slot.stage = GameSlot::Stage::Playing;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    auto play_move(GameSlot &slot) -> void {
+        if (slot.state->check_finished()) {
+            finish_game(slot, true);
+            return;
+        }
+
+        const auto side = side_to_move(slot);
+        auto &engine = slot.engines[side];
+
+        // Builtin engines give us their move directly
+        if (auto *const builtin = dynamic_cast<BuiltinEngine *>(engine.get())) {
+            const auto t0 = std::chrono::steady_clock::now();
+            const auto move = builtin->search(slot.state->position(), slot.state->search_settings());
+            const auto t1 = std::chrono::steady_clock::now();
+            const auto movetime = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+            slot.state->apply(move, movetime, movetime);
+            return;
+        }
+
+        engine->position(slot.state->startpos(), slot.state->moves(), slot.state->position());
+
+        // Ask for the engine to be ready, and wait for the reply
+        if (auto async = slot.async[side]) {
+            const auto &engine_settings = side == 0 ? slot.game->engine1 : slot.game->engine2;
+
+            if (engine_settings.isready) {
+                async->request_isready();
+                async->flush();
+                slot.stage = GameSlot::Stage::Ready;
+                start_deadline(slot);
+            } else {
+                start_search(slot, async);
+            }
+
+            return;
+        }
+
+        // Everything else replies straight away
+        engine->isready();
+        const auto t0 = std::chrono::steady_clock::now();
+        const auto movestr = engine->go(slot.state->search_settings());
+        const auto t1 = std::chrono::steady_clock::now();
+        slot.state->apply(movestr,
+                          std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0),
+                          std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0));
+    }
+
+    // Ask the engine to move for its move, and start its clock
+    auto start_search(GameSlot &slot, AsyncEngine *engine) -> void {
+        slot.stage = GameSlot::Stage::Go;
+        slot.t0 = std::chrono::steady_clock::now();
+        start_deadline(slot);
+        engine->request_go(slot.state->search_settings());
+        engine->flush();
+    }
+
+    // The engines are told to stop by being shut down rather than waited on, so they aren't reused
+    auto abort_games() -> void {
+        for (auto &slot : m_slots) {
+            if (slot.stage == GameSlot::Stage::Waiting) {
+                slot.stage = GameSlot::Stage::Idle;
+            } else if (slot.stage != GameSlot::Stage::Idle) {
+                slot.state->abort();
+                finish_game(slot, false);
+            }
+        }
+    }
+
+    auto crash(GameSlot &slot) -> void {
+        slot.state->crash();
+        finish_game(slot, false);
+    }
+
+    auto finish_game(GameSlot &slot, const bool engines_okay) -> void {
+        for (std::size_t side = 0; side < 2; ++side) {
+            if (slot.async[side]) {
+                epoll_ctl(m_epoll, EPOLL_CTL_DEL, slot.async[side]->native_handle(), nullptr);
+            }
+        }
+
+        const auto game_data = slot.state->finish();
+        const auto game = *slot.game;
+        slot.state.reset();
+        slot.game.reset();
+        slot.async = {nullptr, nullptr};
+        slot.deadline.reset();
+        slot.stage = GameSlot::Stage::Idle;
+
+        return_engines(m_engine_pool,
+                       game,
+                       std::move(slot.engines[0]),
+                       std::move(slot.engines[1]),
+                       engines_okay && game_data.reason != ResultReason::EngineCrash);
+
+        if (m_budget) {
+            m_budget->release(slot.resources);
+        }
+
+        record_game(slot.id, m_context, slot.game_info, game, game_data, m_tally, m_stop, m_game_writer);
+    }
+
+    const MatchContext &m_context;
+    std::atomic<std::size_t> &m_next_game;
+    StopToken &m_stop;
+    EnginePool &m_engine_pool;
+    ResultsTally &m_tally;
+    ResourceBudget *m_budget;
+    GameWriter *m_game_writer;
+    // Never resized, games in progress refer to their slot
+    std::vector<GameSlot> m_slots;
+    int m_epoll = -1;
+};
+
+}  // namespace
+
+void event_loop(const std::size_t first_id,
+                const std::size_t num_games,
+                const MatchContext &context,
+                std::atomic<std::size_t> &next_game,
+                StopToken &stop,
+                EnginePool &engine_pool,
+                ResultsTally &tally,
+                ResourceBudget *budget,
+                GameWriter *game_writer) {
+    EventLoop loop(first_id, num_games, context, next_game, stop, engine_pool, tally, budget, game_writer);
+    loop.run();
+}
+
+#else
+
+void event_loop(const std::size_t,
+                const std::size_t,
+                const MatchContext &,
+                std::atomic<std::size_t> &,
+                StopToken &,
+                EnginePool &,
+                ResultsTally &,
+                ResourceBudget *,
+                GameWriter *) {
+    throw std::runtime_error("The event loop is only supported on Linux");
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef MATCH_EVENT_LOOP_HPP
+#define MATCH_EVENT_LOOP_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../tournament/generator.hpp"
+#include "callbacks.hpp"
+#include "context.hpp"
+
+class EnginePool;
+class ResultsTally;
+class GameWriter;
+class ResourceBudget;
+class StopToken;
+
+// Play several games at once from a single thread
+// Instead of blocking on one engine at a time, wait on every engine in every game and handle whichever replies first
+// Uses worker ids [first_id, first_id + num_games) for the results tally
+void event_loop(const std::size_t first_id,
+                const std::size_t num_games,
+                const MatchContext &context,
+                std::atomic<std::size_t> &next_game,
+                StopToken &stop,
+                EnginePool &engine_pool,
+                ResultsTally &tally,
+                ResourceBudget *budget,
+                GameWriter *game_writer);
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef MATCH_GAME_WRITER_HPP
+#define MATCH_GAME_WRITER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../binary.hpp"
+#include "../pgn.hpp"
+#include "../play.hpp"
+#include "checkpoint.hpp"
+#include "settings.hpp"
+
+// Writes finished games to the .pgn and binary files from its own thread
+// The files are kept open and games are written in batches, so workers only ever have to hand a game over
+// The checkpoint is saved straight after each batch, so it agrees with the games in the files
+// Everything pushed is written by the time stop() returns
+class GameWriter {
+   public:
+    [[nodiscard]] GameWriter(const Settings &settings,
+                             const std::vector<std::string> &names,
+                             Checkpoint checkpoint,
+                             const std::size_t max_queued = 1024,
+                             const std::size_t batch_size = 64,
+                             const std::chrono::milliseconds flush_interval = std::chrono::seconds(1))
+        : m_settings(settings),
+          m_names(names),
+          m_checkpoint(std::move(checkpoint)),
+          m_max_queued(max_queued),
+          m_batch_size(batch_size),
+          m_flush_interval(flush_interval) {
+        if (settings.pgn.enabled && !settings.pgn.path.empty()) {
+            m_pgn_file.open(settings.pgn.path, std::fstream::out | std::fstream::app);
+        }
+
+        if (settings.binary.enabled && !settings.binary.path.empty()) {
+            // New files need a header, and every match starts with its engine names
+            std::error_code ec;
+            const auto is_new = std::filesystem::file_size(settings.binary.path, ec) == 0 || ec;
+            std::string buffer = is_new ? binary_header() : "";
+
+            m_binary_file.open(settings.binary.path, std::fstream::out | std::fstream::app | std::fstream::binary);
+            for (std::size_t i = 0; i < m_names.size(); ++i) {
+                format_binary_engine(buffer, i, m_names[i]);
+            }
+            m_binary_file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        }
+
+        m_thread = std::thread(&GameWriter::run, this);
+    }
+
+    ~GameWriter() {
+        stop();
+    }
+
+    // Queue a game to be written, waits if the writer has fallen too far behind
+    auto push(const GameInfo &game_info, GameThingy game) -> void {
+        std::unique_lock lock(m_mutex);
+        m_not_full.wait(lock, [this] {
+            return m_queue.size() < m_max_queued || m_stop;
+        });
+        m_queue.push_back({game_info, std::move(game)});
+        m_not_empty.notify_one();
+    }
+
+    auto stop() -> void {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop = true;
+        }
+        m_not_empty.notify_one();
+        m_not_full.notify_all();
+
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+   private:
+    struct Entry {
+        GameInfo game_info;
+        GameThingy game;
+    };
+
+    auto run() -> void {
+        std::deque<Entry> batch;
+        std::string pgn_buffer;
+        std::string binary_buffer;
+        std::size_t num_buffered = 0;
+        auto last_flush = std::chrono::steady_clock::now();
+
+        while (true) {
+            auto is_stopping = false;
+
+            // Take everything that's been queued
+            {
+                std::unique_lock lock(m_mutex);
+                m_not_empty.wait_for(lock, m_flush_interval, [this] {
+                    return !m_queue.empty() || m_stop;
+                });
+                std::swap(batch, m_queue);
+                is_stopping = m_stop;
+            }
+            m_not_full.notify_all();
+
+            for (const auto &entry : batch) {
+                const auto engine1 = entry.game_info.idx_player1;
+                const auto engine2 = entry.game_info.idx_player2;
+                if (m_pgn_file.is_open()) {
+                    format_pgn(pgn_buffer, m_settings.pgn, m_names[engine1], m_names[engine2], entry.game);
+                }
+                if (m_binary_file.is_open()) {
+                    format_binary_game(binary_buffer, engine1, engine2, entry.game);
+                }
+                if (m_settings.checkpoint.enabled) {
+                    m_checkpoint.add(entry.game_info, entry.game);
+                }
+                num_buffered++;
+            }
+            batch.clear();
+
+            const auto now = std::chrono::steady_clock::now();
+            const auto is_flush_due = num_buffered >= m_batch_size || now - last_flush >= m_flush_interval;
+
+            if (num_buffered > 0 && (is_flush_due || is_stopping)) {
+                if (m_pgn_file.is_open()) {
+                    m_pgn_file.write(pgn_buffer.data(), static_cast<std::streamsize>(pgn_buffer.size()));
+                    m_pgn_file.flush();
+                }
+                if (m_binary_file.is_open()) {
+                    m_binary_file.write(binary_buffer.data(), static_cast<std::streamsize>(binary_buffer.size()));
+                    m_binary_file.flush();
+                }
+                // A checkpoint that can't be saved shouldn't stop the match, or the games being written
+                if (m_settings.checkpoint.enabled) {
+                    try {
+                        save_checkpoint(m_settings.checkpoint.path, m_checkpoint, m_settings);
+                    } catch (const std::exception &e) {
+                        std::cerr << "Could not save checkpoint: " << e.what() << "\n";
+                    }
+                }
+                pgn_buffer.clear();
+                binary_buffer.clear();
+                num_buffered = 0;
+                last_flush = now;
+            }
+
+            if (is_stopping) {
+                return;
+            }
+        }
+    }
+
+    const Settings &m_settings;
+    const std::vector<std::string> m_names;
+    Checkpoint m_checkpoint;
+    const std::size_t m_max_queued;
+    const std::size_t m_batch_size;
+    const std::chrono::milliseconds m_flush_interval;
+    std::ofstream m_pgn_file;
+    std::ofstream m_binary_file;
+    std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    std::deque<Entry> m_queue;
+    bool m_stop = false;
+    std::thread m_thread;
+};
+
+#endif
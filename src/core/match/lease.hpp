@@ -0,0 +1,178 @@
+#ifndef MATCH_LEASE_HPP
+#define MATCH_LEASE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <optional>
+#include <vector>
+
+// Which games have been handed out to which nodes, for a coordinator sharing a match between machines
+// Games are numbered [0, num_games) and handed out in order, except that games given back come first
+// A node holds its games until it finishes them, disconnects, or goes quiet for long enough that its lease expires,
+// after which they're given to someone else. Whichever result for a game arrives first is the one that counts
+class [[nodiscard]] LeaseTable {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit LeaseTable(const std::size_t num_games) : m_state(num_games, State::Pending), m_holder(num_games, 0) {
+    }
+
+    // Up to count games for the node, which it holds until the expiry time unless it's renewed
+    [[nodiscard]] auto lease(const std::size_t node, const std::size_t count, const Clock::time_point expiry)
+        -> std::vector<std::size_t> {
+        std::vector<std::size_t> games;
+
+        while (games.size() < count && !m_returned.empty()) {
+            const auto idx = m_returned.front();
+            m_returned.pop_front();
+            // Finished by the node that had it before
+            if (m_state[idx] == State::Pending) {
+                games.push_back(idx);
+            }
+        }
+
+        while (games.size() < count && m_next < m_state.size()) {
+            games.push_back(m_next++);
+        }
+
+        if (games.empty()) {
+            return games;
+        }
+
+        auto &lease = m_leases[node];
+        lease.expiry = expiry;
+        for (const auto idx : games) {
+            m_state[idx] = State::Leased;
+            m_holder[idx] = node;
+            lease.games.push_back(idx);
+        }
+        m_num_leased += games.size();
+
+        return games;
+    }
+
+    // Whether this is the first result for the game, a game can be finished by a node after its lease has expired
+    [[nodiscard]] auto complete(const std::size_t idx) -> bool {
+        if (idx >= m_state.size() || m_state[idx] == State::Done) {
+            return false;
+        }
+
+        if (m_state[idx] == State::Leased) {
+            remove(m_holder[idx], idx);
+            m_num_leased--;
+        }
+
+        m_state[idx] = State::Done;
+        m_num_done++;
+        return true;
+    }
+
+    // The node is still alive, so hold on to its games for longer
+    auto renew(const std::size_t node, const Clock::time_point expiry) -> void {
+        const auto iter = m_leases.find(node);
+        if (iter != m_leases.end()) {
+            iter->second.expiry = expiry;
+        }
+    }
+
+    // Give back every game the node was holding, returns how many there were
+    auto release(const std::size_t node) -> std::size_t {
+        const auto iter = m_leases.find(node);
+        if (iter == m_leases.end()) {
+            return 0;
+        }
+
+        const auto games = std::move(iter->second.games);
+        m_leases.erase(iter);
+
+        for (const auto idx : games) {
+            m_state[idx] = State::Pending;
+            m_returned.push_back(idx);
+        }
+        m_num_leased -= games.size();
+
+        return games.size();
+    }
+
+    // Give back the games of every node whose lease has run out, returns how many there were
+    auto expire(const Clock::time_point now) -> std::size_t {
+        std::vector<std::size_t> expired;
+        for (const auto &[node, lease] : m_leases) {
+            if (lease.expiry <= now) {
+                expired.push_back(node);
+            }
+        }
+
+        std::size_t num_returned = 0;
+        for (const auto node : expired) {
+            num_returned += release(node);
+        }
+        return num_returned;
+    }
+
+    // When the next lease runs out, if anyone is holding games
+    [[nodiscard]] auto next_expiry() const -> std::optional<Clock::time_point> {
+        std::optional<Clock::time_point> next;
+        for (const auto &[node, lease] : m_leases) {
+            if (!next || lease.expiry < *next) {
+                next = lease.expiry;
+            }
+        }
+        return next;
+    }
+
+    // Whether there are games that haven't been handed out, or have been given back
+    [[nodiscard]] auto has_available() const noexcept -> bool {
+        return m_num_done + m_num_leased < m_state.size();
+    }
+
+    [[nodiscard]] auto num_leased() const noexcept -> std::size_t {
+        return m_num_leased;
+    }
+
+    [[nodiscard]] auto is_finished() const noexcept -> bool {
+        return m_num_done == m_state.size();
+    }
+
+   private:
+    enum class State : std::uint8_t
+    {
+        Pending,
+        Leased,
+        Done,
+    };
+
+    struct Lease {
+        Clock::time_point expiry;
+        std::vector<std::size_t> games;
+    };
+
+    auto remove(const std::size_t node, const std::size_t idx) -> void {
+        const auto iter = m_leases.find(node);
+        if (iter == m_leases.end()) {
+            return;
+        }
+
+        auto &games = iter->second.games;
+        games.erase(std::remove(games.begin(), games.end(), idx), games.end());
+        if (games.empty()) {
+            m_leases.erase(iter);
+        }
+    }
+
+    std::vector<State> m_state;
+    // Which node has each leased game
+    std::vector<std::size_t> m_holder;
+    // Games given back by nodes, to be handed out again before any new ones
+    std::deque<std::size_t> m_returned;
+    std::map<std::size_t, Lease> m_leases;
+    std::size_t m_next = 0;
+    std::size_t m_num_leased = 0;
+    std::size_t m_num_done = 0;
+};
+
+#endif
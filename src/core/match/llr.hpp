@@ -0,0 +1,23 @@
+#ifndef MATCH_LLR_HPP
+#define MATCH_LLR_HPP
+
+#include <sprt.hpp>
+#include "results.hpp"
+#include "settings.hpp"
+
+// The SPRT log likelihood ratio of the first engine against the second, using the model from the settings
+[[nodiscard]] inline auto match_llr(const Settings &settings, const Results &results) -> float {
+    if (settings.sprt.pentanomial) {
+        return sprt::get_llr_pentanomial(results.pentanomial, settings.sprt.elo0, settings.sprt.elo1);
+    }
+
+    const auto score = settings.engines.empty() ? results.scores.end() : results.scores.find(settings.engines[0].name);
+    if (score == results.scores.end()) {
+        return 0.0f;
+    }
+
+    return sprt::get_llr(
+        score->second.wins, score->second.losses, score->second.draws, settings.sprt.elo0, settings.sprt.elo1);
+}
+
+#endif
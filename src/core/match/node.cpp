@@ -0,0 +1,325 @@
+#include "node.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../play.hpp"
+#include "connection.hpp"
+#include "protocol.hpp"
+#include "settings.hpp"
+#include "stop.hpp"
+#include "tally.hpp"
+#include "worker.hpp"
+// Engines
+#include "../engine/engine.hpp"
+#include "../engine/pool.hpp"
+
+#ifndef _WIN32
+#include <poll.h>
+#endif
+
+#ifndef _WIN32
+
+namespace {
+
+// Our end of the connection to the coordinator, shared by every game thread
+// Replies are read on a thread of their own and matched to the requests they answer by seq
+class Link {
+   public:
+    [[nodiscard]] Link(Connection connection, StopToken &stop) : m_connection(std::move(connection)), m_stop(stop) {
+    }
+
+    // Introduce ourselves, and find out how often to ping
+    auto hello(const std::vector<std::string> &names, const nlohmann::json &settings) -> void {
+        send({{"type", "hello"}, {"engines", names}, {"settings", settings}});
+
+        while (true) {
+            const auto message = m_connection.next_message();
+            if (!message) {
+                pollfd fd = {m_connection.fd(), POLLIN, 0};
+                poll(&fd, 1, -1);
+                if (!m_connection.receive()) {
+                    throw std::runtime_error("The coordinator closed the connection");
+                }
+                continue;
+            }
+
+            const auto type = message->value("type", "");
+            if (type == "welcome") {
+                m_ping_ms = std::max(1, message->value("ping", 1000));
+                return;
+            } else if (type == "error") {
+                throw std::runtime_error("The coordinator said: " + message->value("message", ""));
+            }
+        }
+    }
+
+    // Read until the connection closes
+    auto read() -> void {
+        auto last_ping = std::chrono::steady_clock::now();
+
+        while (true) {
+            pollfd fd = {m_connection.fd(), POLLIN, 0};
+            poll(&fd, 1, m_ping_ms);
+
+            // Let the coordinator know we haven't gone anywhere, even if our games are long
+            const auto now = std::chrono::steady_clock::now();
+            if (now - last_ping >= std::chrono::milliseconds(m_ping_ms)) {
+                send({{"type", "ping"}});
+                last_ping = now;
+            }
+
+            if (!fd.revents) {
+                continue;
+            }
+
+            const auto alive = m_connection.receive();
+            while (const auto message = m_connection.next_message()) {
+                const auto type = message->value("type", "");
+
+                std::lock_guard lock(m_mutex);
+                if (type == "stop") {
+                    m_stopped = true;
+                    if (message->value("abort", false)) {
+                        m_stop.abort();
+                    } else {
+                        m_stop.finish();
+                    }
+                } else if (message->contains("seq")) {
+                    m_replies[message->value("seq", 0)] = *message;
+                }
+                m_cv.notify_all();
+            }
+
+            if (!alive) {
+                std::lock_guard lock(m_mutex);
+                // Nobody is left to send the results of unfinished games to
+                m_disconnected = true;
+                if (!m_stopped && !m_closing) {
+                    std::cerr << "Lost connection to the coordinator\n";
+                }
+                m_stop.abort();
+                m_cv.notify_all();
+                return;
+            }
+        }
+    }
+
+    // Send a message and wait for the reply, nothing if the connection closed first
+    [[nodiscard]] auto request(nlohmann::json message) -> std::optional<nlohmann::json> {
+        std::unique_lock lock(m_mutex);
+        const auto seq = m_next_seq++;
+        lock.unlock();
+
+        message["seq"] = seq;
+        send(message);
+
+        lock.lock();
+        m_cv.wait(lock, [this, seq] {
+            return m_disconnected || m_replies.contains(seq);
+        });
+
+        const auto iter = m_replies.find(seq);
+        if (iter == m_replies.end()) {
+            return std::nullopt;
+        }
+
+        auto reply = std::move(iter->second);
+        m_replies.erase(iter);
+        return reply;
+    }
+
+    auto send(const nlohmann::json &message) -> void {
+        std::lock_guard lock(m_send_mutex);
+        m_connection.send(message);
+    }
+
+    // Sleep until it's time to ask for games again, or the match stops
+    auto wait(const int ms) -> void {
+        std::unique_lock lock(m_mutex);
+        m_cv.wait_for(lock, std::chrono::milliseconds(ms), [this] {
+            return m_disconnected || m_stop.is_finishing();
+        });
+    }
+
+    // Wakes the reader, which then returns
+    auto close() noexcept -> void {
+        {
+            std::lock_guard lock(m_mutex);
+            m_closing = true;
+        }
+        m_connection.shutdown();
+    }
+
+   private:
+    Connection m_connection;
+    StopToken &m_stop;
+    std::mutex m_send_mutex;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::map<int, nlohmann::json> m_replies;
+    int m_next_seq = 0;
+    int m_ping_ms = 1000;
+    bool m_stopped = false;
+    bool m_closing = false;
+    bool m_disconnected = false;
+};
+
+void node_worker(const std::size_t id,
+                 const Settings &settings,
+                 const Callbacks &callbacks,
+                 Link &link,
+                 StopToken &stop,
+                 EnginePool &engine_pool,
+                 ResultsTally &tally) {
+    // The coordinator decides when the match ends, and might want games abandoned
+    const auto *const abort = stop.aborted_flag();
+
+    while (!stop.is_finishing()) {
+        const auto reply = link.request({{"type", "lease"}, {"count", settings.distributed.batch}});
+        if (!reply) {
+            return;
+        }
+
+        const auto type = reply->value("type", "");
+        if (type == "wait") {
+            link.wait(reply->value("ms", 1000));
+            continue;
+        } else if (type != "games") {
+            return;
+        }
+
+        // Every game leased has to be played, the coordinator is waiting on them even if the match is stopping
+        for (const auto &leased : reply->at("games")) {
+            if (stop.is_aborted()) {
+                return;
+            }
+
+            const auto idx = leased.at("idx").get<std::size_t>();
+            const auto game_id = leased.at("id").get<std::size_t>();
+            const auto idx_player1 = leased.at("player1").get<std::size_t>();
+            const auto idx_player2 = leased.at("player2").get<std::size_t>();
+            if (idx_player1 >= settings.engines.size() || idx_player2 >= settings.engines.size()) {
+                std::cerr << "The coordinator asked for an engine we don't have\n";
+                stop.abort();
+                return;
+            }
+
+            const auto startpos = libataxx::Position(leased.at("opening").get<std::string>());
+            const auto game =
+                GameSettings{startpos, settings.engines[idx_player1], settings.engines[idx_player2]};
+
+            tally.started(id);
+
+            callbacks.on_game_started(0, game.engine1.name, game.engine2.name);
+
+            auto engine1 = get_engine(engine_pool, game.engine1, callbacks);
+            auto engine2 = get_engine(engine_pool, game.engine2, callbacks);
+
+            GameThingy game_data;
+            auto engines_okay = false;
+
+            // Play the game
+            try {
+                game_data = play(settings.adjudication, game, engine1, engine2, abort);
+                engines_okay = game_data.reason != ResultReason::EngineCrash;
+            } catch (std::invalid_argument &e) {
+                std::cerr << e.what() << "\n";
+            } catch (const char *e) {
+                std::cerr << e << "\n";
+            } catch (std::exception &e) {
+                std::cerr << e.what() << "\n";
+            } catch (...) {
+                std::cerr << "Error woops\n";
+            }
+
+            return_engines(engine_pool, game, std::move(engine1), std::move(engine2), engines_okay);
+
+            // The coordinator gives abandoned games to someone else
+            if (game_data.reason == ResultReason::Aborted) {
+                tally.aborted(id);
+                return;
+            }
+
+            link.send({{"type", "result"}, {"idx", idx}, {"id", game_id}, {"game", game_to_json(game_data)}});
+
+            callbacks.on_game_finished(0, game.engine1.name, game.engine2.name);
+
+            // Keep our own count of what's been played here
+            auto is_black = game_data.startpos.get_turn() == libataxx::Side::Black;
+            for (const auto &move : game_data.history) {
+                const auto engine = is_black ? idx_player1 : idx_player2;
+                tally.moved(id, engine, move.first_reply_us, move.total_us);
+                is_black = !is_black;
+            }
+            tally.played(id, idx_player1, idx_player2, game_data.result, game_data.reason);
+        }
+    }
+}
+
+}  // namespace
+
+auto run_node(const Settings &settings, const Callbacks &callbacks) -> Results {
+    std::vector<std::string> names;
+    for (const auto &engine : settings.engines) {
+        names.emplace_back(engine.name);
+    }
+
+    StopToken stop;
+    Link link(Connection::connect(settings.distributed.host, settings.distributed.port), stop);
+    link.hello(names, playing_settings(settings));
+
+    ResultsTally tally(names, settings.concurrency);
+
+    // Engines are shared between threads, and every thread needs two at once
+    const auto max_engines = std::max(settings.max_engines, 2 * settings.concurrency);
+    EnginePool engine_pool(max_engines);
+
+    std::thread reader(&Link::read, &link);
+
+    // Start game threads
+    std::vector<std::thread> threads;
+    for (int i = 0; i < settings.concurrency; ++i) {
+        threads.emplace_back(node_worker,
+                             i,
+                             std::cref(settings),
+                             std::cref(callbacks),
+                             std::ref(link),
+                             std::ref(stop),
+                             std::ref(engine_pool),
+                             std::ref(tally));
+    }
+
+    // Wait for game threads to finish
+    for (auto &thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    link.close();
+    reader.join();
+
+    auto results = tally.snapshot();
+    const auto pool_stats = engine_pool.stats();
+    results.engines_created = pool_stats.created;
+    results.engines_reused = pool_stats.reused;
+    results.engine_startup_us = pool_stats.startup_us;
+
+    return results;
+}
+
+#else
+
+auto run_node(const Settings &, const Callbacks &) -> Results {
+    throw std::runtime_error("Distributed matches aren't supported on Windows");
+}
+
+#endif
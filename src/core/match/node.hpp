@@ -0,0 +1,14 @@
+#ifndef MATCH_NODE_HPP
+#define MATCH_NODE_HPP
+
+#include "callbacks.hpp"
+#include "results.hpp"
+
+class Settings;
+
+// Play games handed out by a coordinator on another machine, sending back the results as each one finishes
+// The settings need the same engines as the coordinator's, with paths that work on this machine
+// Returns the games played here, which the coordinator has already counted. Throws if we can't connect
+[[nodiscard]] auto run_node(const Settings &settings, const Callbacks &callbacks) -> Results;
+
+#endif
@@ -0,0 +1,112 @@
+#include "protocol.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include "../ataxx/parse_move.hpp"
+#include "settings.hpp"
+
+auto playing_settings(const Settings &settings) -> nlohmann::json {
+    const auto &adjudication = settings.adjudication;
+    auto json = nlohmann::json{
+        {"adjudication",
+         {
+             {"gamelength", adjudication.gamelength ? nlohmann::json(*adjudication.gamelength) : nlohmann::json()},
+             {"material", adjudication.material ? nlohmann::json(*adjudication.material) : nlohmann::json()},
+             {"easyfill", adjudication.easyfill ? nlohmann::json(*adjudication.easyfill) : nlohmann::json()},
+             {"timeout_buffer", adjudication.timeout_buffer},
+             {"solve", adjudication.solve ? nlohmann::json(*adjudication.solve) : nlohmann::json()},
+         }},
+        {"engines", nlohmann::json::array()},
+    };
+
+    for (const auto &engine : settings.engines) {
+        const auto &tc = engine.tc;
+        json["engines"].push_back({
+            {"name", engine.name},
+            {"protocol", static_cast<int>(engine.proto)},
+            {"builtin", engine.builtin},
+            {"timecontrol",
+             {static_cast<int>(tc.type),
+              tc.btime,
+              tc.wtime,
+              tc.binc,
+              tc.winc,
+              tc.movestogo,
+              tc.movetime,
+              tc.ply,
+              tc.nodes}},
+            {"options", engine.options},
+            {"ponder", engine.ponder},
+        });
+    }
+
+    return json;
+}
+
+auto playing_settings_mismatch(const nlohmann::json &ours, const nlohmann::json &theirs)
+    -> std::optional<std::string> {
+    if (!theirs.is_object() || theirs.value("adjudication", nlohmann::json()) != ours.at("adjudication")) {
+        return "adjudication";
+    }
+
+    const auto &our_engines = ours.at("engines");
+    const auto their_engines = theirs.value("engines", nlohmann::json::array());
+    if (their_engines.size() != our_engines.size()) {
+        return "engines";
+    }
+
+    for (std::size_t i = 0; i < our_engines.size(); ++i) {
+        if (their_engines[i] != our_engines[i]) {
+            return "engine " + our_engines[i].at("name").get<std::string>();
+        }
+    }
+
+    return std::nullopt;
+}
+
+auto game_to_json(const GameThingy &game) -> nlohmann::json {
+    auto moves = nlohmann::json::array();
+    for (const auto &info : game.history) {
+        moves.push_back({static_cast<std::string>(info.move), info.movetime, info.first_reply_us, info.total_us});
+    }
+
+    return {
+        {"startpos", game.startpos.get_fen()},
+        {"result", static_cast<int>(game.result)},
+        {"reason", static_cast<int>(game.reason)},
+        {"moves", moves},
+    };
+}
+
+auto game_from_json(const nlohmann::json &json) -> GameThingy {
+    const auto result = json.at("result").get<int>();
+    const auto reason = json.at("reason").get<int>();
+    if (result < 0 || result > static_cast<int>(libataxx::Result::None) || reason < 0 ||
+        reason > static_cast<int>(ResultReason::Solved)) {
+        throw std::invalid_argument("Invalid game result");
+    }
+
+    GameThingy game;
+    game.result = static_cast<libataxx::Result>(result);
+    game.reason = static_cast<ResultReason>(reason);
+    game.startpos = libataxx::Position(json.at("startpos").get<std::string>());
+    game.endpos = game.startpos;
+
+    for (const auto &move : json.at("moves")) {
+        auto info = MoveThingy{};
+        info.move = parse_move(move.at(0).get<std::string>());
+        info.movetime = move.at(1).get<int>();
+        info.first_reply_us = move.at(2).get<std::int64_t>();
+        info.total_us = move.at(3).get<std::int64_t>();
+
+        if (!game.endpos.is_legal_move(info.move)) {
+            throw std::invalid_argument("Illegal move in game");
+        }
+        game.endpos.makemove(info.move);
+
+        game.history.push_back(info);
+    }
+
+    return game;
+}
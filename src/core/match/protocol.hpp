@@ -0,0 +1,44 @@
+#ifndef MATCH_PROTOCOL_HPP
+#define MATCH_PROTOCOL_HPP
+
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include "../play.hpp"
+
+class Settings;
+
+// A coordinator and its nodes talk over TCP, one JSON object per line, each with a "type"
+//
+// Node to coordinator:
+// "hello"   {"engines": [names], "settings": settings}, sent first, both have to match the coordinator's
+// "lease"   {"seq": n, "count": n}, asks for up to count games, the reply has the same seq
+// "result"  {"idx": n, "id": n, "game": game}, a finished game, idx being the one it was handed out with
+// "ping"    {}, sent every so often so the coordinator knows we're still there
+//
+// Coordinator to node:
+// "welcome" {"ping": ms}, how often to ping
+// "error"   {"message": string}, then the connection is closed
+// "games"   {"seq": n, "games": [{"idx": n, "id": n, "opening": fen, "player1": n, "player2": n}]}
+// "wait"    {"seq": n, "ms": n}, every game is out, but some may be given back so ask again later
+// "done"    {"seq": n}, there are no more games
+// "stop"    {"abort": bool}, sent to every node when the match ends, abort meaning to abandon any games being played
+//
+// Games are {"startpos": fen, "result": n, "reason": n, "moves": [[move, movetime, first_reply_us, total_us]]},
+// with the result and reason numbered the same as in the binary format
+
+// The settings that change how games are played, which every node has to share with the coordinator so that the
+// results are comparable: adjudication, and each engine's protocol, time control, options and pondering
+// Paths and arguments are left out, they depend on the machine
+[[nodiscard]] auto playing_settings(const Settings &settings) -> nlohmann::json;
+
+// Which of the playing settings differ, nothing if they're the same
+[[nodiscard]] auto playing_settings_mismatch(const nlohmann::json &ours, const nlohmann::json &theirs)
+    -> std::optional<std::string>;
+
+[[nodiscard]] auto game_to_json(const GameThingy &game) -> nlohmann::json;
+
+// Throws if the game isn't valid
+[[nodiscard]] auto game_from_json(const nlohmann::json &json) -> GameThingy;
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef MATCH_RESOURCES_HPP
+#define MATCH_RESOURCES_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include "../engine/settings.hpp"
+#include "cores.hpp"
+
+// What a game needs while it's being played
+struct GameResources {
+    int cores = 0;
+    std::int64_t memory = 0;
+};
+
+[[nodiscard]] inline auto game_resources(const EngineSettings &engine1, const EngineSettings &engine2)
+    -> GameResources {
+    return {game_cores(engine1, engine2), static_cast<std::int64_t>(engine_hash(engine1)) + engine_hash(engine2)};
+}
+
+// The cores and megabytes of memory shared by every game being played, so that games only start once their
+// engines fit alongside everything else that's running
+// A game that needs more than there is to give can still be played, but only on its own
+class ResourceBudget {
+   public:
+    [[nodiscard]] ResourceBudget(const int cores, const std::int64_t memory) : m_cores(cores), m_memory(memory) {
+    }
+
+    // Wait until the game fits, then claim what it needs
+    auto acquire(const GameResources &needed) -> void {
+        std::unique_lock lock(m_mutex);
+        m_released.wait(lock, [&] {
+            return fits(needed);
+        });
+        take(needed);
+    }
+
+    // Claim what the game needs if it fits right now
+    [[nodiscard]] auto try_acquire(const GameResources &needed) -> bool {
+        std::lock_guard lock(m_mutex);
+        if (!fits(needed)) {
+            return false;
+        }
+        take(needed);
+        return true;
+    }
+
+    // Give back what a finished game was using
+    auto release(const GameResources &used) -> void {
+        {
+            std::lock_guard lock(m_mutex);
+            m_used_cores -= used.cores;
+            m_used_memory -= used.memory;
+            m_num_games--;
+        }
+        m_released.notify_all();
+    }
+
+   private:
+    [[nodiscard]] auto fits(const GameResources &needed) const noexcept -> bool {
+        return m_num_games == 0 ||
+               (m_used_cores + needed.cores <= m_cores && m_used_memory + needed.memory <= m_memory);
+    }
+
+    auto take(const GameResources &needed) noexcept -> void {
+        m_used_cores += needed.cores;
+        m_used_memory += needed.memory;
+        m_num_games++;
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_released;
+    int m_cores = 0;
+    std::int64_t m_memory = 0;
+    int m_used_cores = 0;
+    std::int64_t m_used_memory = 0;
+    int m_num_games = 0;
+};
+
+#endif
@@ -1,6 +1,11 @@
 #ifndef MATCH_RESULTS_HPP
 #define MATCH_RESULTS_HPP
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 #include <iomanip>
 #include <map>
 #include <string>
@@ -13,13 +18,49 @@ struct Score {
     int played = 0;
 };
 
+// How many times something took a given number of microseconds, in power of two sized buckets
+// Bucket 0 holds zero, bucket n holds [2^(n-1), 2^n), and the last bucket holds everything longer
+struct LatencyHistogram {
+    static constexpr std::size_t size = 24;
+
+    [[nodiscard]] static constexpr auto bucket(const std::int64_t us) noexcept -> std::size_t {
+        const auto width = std::bit_width(static_cast<std::uint64_t>(std::max<std::int64_t>(us, 0)));
+        return std::min<std::size_t>(width, size - 1);
+    }
+
+    [[nodiscard]] static constexpr auto lower_bound(const std::size_t bucket) noexcept -> std::int64_t {
+        return bucket == 0 ? 0 : std::int64_t(1) << (bucket - 1);
+    }
+
+    std::array<int, size> counts = {};
+};
+
+static_assert(LatencyHistogram::bucket(0) == 0);
+static_assert(LatencyHistogram::bucket(1) == 1);
+static_assert(LatencyHistogram::bucket(1000) == 10);
+static_assert(LatencyHistogram::lower_bound(10) <= 1000);
+static_assert(LatencyHistogram::bucket(std::int64_t(1) << 40) == LatencyHistogram::size - 1);
+
+struct Latencies {
+    // From sending go to the first output from the engine
+    LatencyHistogram first_reply;
+    // From sending go to the engine's move
+    LatencyHistogram move;
+};
+
 struct Results {
     int games_started = 0;
     int games_played = 0;
     int black_wins = 0;
     int white_wins = 0;
     int draws = 0;
+    int engines_created = 0;
+    int engines_reused = 0;
+    std::int64_t engine_startup_us = 0;
+    // Pairs of games sharing an opening by how many half points the first engine scored, only for two engines
+    std::array<int, 5> pentanomial = {};
     std::map<std::string, Score> scores;
+    std::map<std::string, Latencies> latencies;
 };
 
 inline std::ostream &operator<<(std::ostream &os, const Score &score) {
@@ -1,45 +1,146 @@
 #include "run.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <memory>
-#include <stdexcept>
 #include <thread>
 #include <vector>
+#include "../opening_book.hpp"
+#include "context.hpp"
+#include "cores.hpp"
+#include "event_loop.hpp"
+#include "game_writer.hpp"
+#include "resources.hpp"
 #include "settings.hpp"
+#include "stats.hpp"
+#include "stop.hpp"
+#include "tally.hpp"
 #include "worker.hpp"
+// Engines
+#include "../engine/pool.hpp"
 // Tournaments
-#include "../tournament/gauntlet.hpp"
+#include "../tournament/create.hpp"
 #include "../tournament/generator.hpp"
-#include "../tournament/roundrobin.hpp"
-#include "../tournament/roundrobin_mixed.hpp"
+#include "../tournament/resume.hpp"
 
-Results run(const Settings &settings, const std::vector<std::string> &openings, const Callbacks &callbacks) {
+Results run(const Settings &settings,
+            const OpeningBook &openings,
+            Checkpoint checkpoint,
+            const Callbacks &callbacks) {
     // Create results & initialise
-    Results results;
+    std::vector<std::string> names;
     for (const auto &engine : settings.engines) {
-        results.scores[engine.name];
+        names.emplace_back(engine.name);
     }
 
     // Create tournament
-    std::shared_ptr<TournamentGenerator> game_generator;
-
-    if (settings.tournament_type == TournamentType::RoundRobin) {
-        game_generator =
-            std::make_shared<RoundRobinGenerator>(settings.engines.size(), settings.num_games, openings.size(), true);
-    } else if (settings.tournament_type == TournamentType::Gauntlet) {
-        game_generator =
-            std::make_shared<GauntletGenerator>(settings.engines.size(), settings.num_games, openings.size(), true);
-    } else if (settings.tournament_type == TournamentType::RoundRobinMixed) {
-        game_generator = std::make_shared<RoundRobinMixedGenerator>(
-            settings.engines.size(), settings.num_games, openings.size(), true);
-    } else {
-        throw std::runtime_error("Unknown tournament type");
+    const auto game_generator =
+        make_generator(settings.tournament_type, settings.engines.size(), settings.num_games, openings.size());
+
+    // A checkpoint from a different match would give nonsense results
+    check_checkpoint(checkpoint, names, settings.tournament_type, openings, game_generator->expected());
+
+    // Carry on from where the checkpoint left off
+    ResultsTally tally(names, settings.concurrency, game_generator->expected());
+    tally.restore(checkpoint.results, checkpoint.half_pairs);
+    const auto remaining_games =
+        std::make_shared<ResumeGenerator>(game_generator, checkpoint.finished_below, checkpoint.finished);
+
+    // Engines are shared between threads, and every thread needs two at once
+    const auto max_engines = std::max(settings.max_engines, 2 * settings.concurrency);
+    EnginePool engine_pool(max_engines);
+
+    // Games and checkpoints are written in the background
+    std::unique_ptr<GameWriter> game_writer;
+    if ((settings.pgn.enabled && !settings.pgn.path.empty()) ||
+        (settings.binary.enabled && !settings.binary.path.empty()) || settings.checkpoint.enabled) {
+        game_writer = std::make_unique<GameWriter>(settings, names, checkpoint);
+    }
+
+    // Don't start anything if the SPRT had already finished
+    const auto is_finished = is_sprt_stop(settings, tally.snapshot());
+
+    // Decide which cores each game gets before anything starts
+    const auto slot_cores = settings.affinity
+                                ? layout_cores(numa_cores(), settings.concurrency, cores_per_game(settings))
+                                : std::vector<std::vector<int>>{};
+
+    // Games only start once the cores and memory their engines need are free
+    std::unique_ptr<ResourceBudget> budget;
+    if (settings.resources.enabled) {
+        const auto cores = settings.resources.cores > 0 ? settings.resources.cores : available_cores();
+        auto memory = settings.resources.memory > 0 ? settings.resources.memory : available_memory();
+        if (memory <= 0) {
+            memory = std::numeric_limits<std::int64_t>::max() / 2;
+        }
+        budget = std::make_unique<ResourceBudget>(cores, memory);
+    }
+
+    // Shared by every thread rather than copied into each of them
+    const auto context = MatchContext{settings, openings, *remaining_games, callbacks, slot_cores};
+
+    // Anyone watching the match reads the tally from the server's own thread
+    std::unique_ptr<StatsServer> stats_server;
+    if (settings.stats.enabled) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto games_restored = checkpoint.results.games_played;
+        const auto make_stats = [&settings, &tally, start, games_restored] {
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            return stats_json(settings, tally.snapshot(), games_restored, elapsed);
+        };
+        stats_server = std::make_unique<StatsServer>(
+            settings.stats.path, std::chrono::milliseconds(settings.stats.interval), make_stats);
     }
 
+    // Games are claimed by incrementing this
+    std::atomic<std::size_t> next_game = 0;
+
+    // Every thread stops once any of them decides the match is over
+    StopToken stop;
+
     // Create threads
     std::vector<std::thread> threads;
 
-    // Start game threads
-    for (int i = 0; i < settings.concurrency; ++i) {
-        threads.emplace_back(worker, settings, openings, game_generator, std::ref(results), std::cref(callbacks));
+    if (is_finished) {
+        // Nothing left to play
+    } else if (settings.eventloop.enabled) {
+        // Start event loop threads, sharing the games between them
+        const auto num_threads = std::min(settings.eventloop.threads, settings.concurrency);
+        std::size_t first_id = 0;
+
+        for (int i = 0; i < num_threads; ++i) {
+            const std::size_t num_games =
+                settings.concurrency / num_threads + (i < settings.concurrency % num_threads ? 1 : 0);
+
+            threads.emplace_back(event_loop,
+                                 first_id,
+                                 num_games,
+                                 std::cref(context),
+                                 std::ref(next_game),
+                                 std::ref(stop),
+                                 std::ref(engine_pool),
+                                 std::ref(tally),
+                                 budget.get(),
+                                 game_writer.get());
+
+            first_id += num_games;
+        }
+    } else {
+        // Start game threads
+        for (int i = 0; i < settings.concurrency; ++i) {
+            threads.emplace_back(worker,
+                                 i,
+                                 std::cref(context),
+                                 std::ref(next_game),
+                                 std::ref(stop),
+                                 std::ref(engine_pool),
+                                 std::ref(tally),
+                                 budget.get(),
+                                 game_writer.get());
+        }
     }
 
     // Wait for game threads to finish
@@ -49,6 +150,17 @@ Results run(const Settings &settings, const std::vector<std::string> &openings,
         }
     }
 
+    // Make sure every game has been written
+    if (game_writer) {
+        game_writer->stop();
+    }
+
+    auto results = tally.snapshot();
+    const auto pool_stats = engine_pool.stats();
+    results.engines_created = pool_stats.created;
+    results.engines_reused = pool_stats.reused;
+    results.engine_startup_us = pool_stats.startup_us;
+
     assert(results.games_started == results.games_played);
     assert(results.black_wins + results.white_wins + results.draws == results.games_played);
 
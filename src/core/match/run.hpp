@@ -3,11 +3,17 @@
 
 #include <vector>
 #include "callbacks.hpp"
+#include "checkpoint.hpp"
 #include "results.hpp"
 #include "settings.hpp"
 
 class Settings;
+class OpeningBook;
 
-Results run(const Settings &settings, const std::vector<std::string> &openings, const Callbacks &callbacks);
+// Play the games the checkpoint hasn't already finished
+Results run(const Settings &settings,
+            const OpeningBook &openings,
+            Checkpoint checkpoint,
+            const Callbacks &callbacks);
 
 #endif
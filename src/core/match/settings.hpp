@@ -5,6 +5,7 @@
 #include <ostream>
 #include <string>
 #include <vector>
+#include "../binary.hpp"
 #include "../engine/settings.hpp"
 #include "../pgn.hpp"
 #include "../tournament/types.hpp"
@@ -16,25 +17,82 @@ struct SPRTSettings {
     float beta = 0.05f;
     float elo0 = 0.0f;
     float elo1 = 5.0f;
+    // Score pairs of games sharing an opening together, rather than counting wins, losses and draws
+    // Off unless asked for, the elo bounds mean something different with each model
+    bool pentanomial = false;
+    // Stop the games being played once the SPRT finishes, rather than letting them and their pairs finish
+    bool abort = false;
+};
+
+struct EventLoopSettings {
+    bool enabled = false;
+    int threads = 1;
+};
+
+struct ResourceSettings {
+    bool enabled = false;
+    // Zero means use everything the machine has
+    int cores = 0;
+    int memory = 0;
+};
+
+struct StatsSettings {
+    std::string path = "cuteataxx.sock";
+    int interval = 1000;
+    bool enabled = false;
+};
+
+// Sharing a match between machines, one coordinator handing out games to any number of nodes playing them
+struct DistributedSettings {
+    enum class Mode : int
+    {
+        Off,
+        Coordinator,
+        Node,
+    };
+
+    Mode mode = Mode::Off;
+    // Where the coordinator listens, and where nodes connect to
+    std::string host = "127.0.0.1";
+    int port = 23456;
+    // How many games a node asks for at once
+    int batch = 2;
+    // How long a node can go without being heard from before its games are given to someone else, in milliseconds
+    int lease_timeout = 60000;
+};
+
+struct CheckpointSettings {
+    std::string path = "checkpoint.json";
+    bool enabled = false;
 };
 
 struct Settings {
     int ratinginterval = 10;
     int concurrency = 1;
+    int max_engines = 0;
     int num_games = 100;
     bool debug = false;
     bool recover = false;
     bool verbose = false;
     bool repeat = true;
     bool shuffle = false;
+    bool openings_index = false;
+    bool openings_unique = true;
     bool print_early = true;
+    bool affinity = false;
     TournamentType tournament_type = TournamentType::RoundRobin;
     std::string openings_path;
     std::vector<EngineSettings> engines;
     SearchSettings tc;
     AdjudicationSettings adjudication;
     PGNSettings pgn;
+    BinarySettings binary;
     SPRTSettings sprt;
+    EventLoopSettings eventloop;
+    ResourceSettings resources;
+    CheckpointSettings checkpoint;
+    StatsSettings stats;
+    DistributedSettings distributed;
 };
 
 inline std::ostream &operator<<(std::ostream &os, const SearchSettings &ss) {
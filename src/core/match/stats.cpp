@@ -0,0 +1,248 @@
+#include "stats.hpp"
+#include <elo.hpp>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <sprt.hpp>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include "llr.hpp"
+#include "results.hpp"
+#include "settings.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// How long to give a client to send its request before assuming it isn't going to
+constexpr int request_timeout_ms = 100;
+
+// The mean of a latency histogram in milliseconds, taking the middle of each bucket
+[[nodiscard]] auto mean_ms(const LatencyHistogram &histogram) -> double {
+    double total = 0.0;
+    int count = 0;
+
+    for (std::size_t i = 0; i < LatencyHistogram::size; ++i) {
+        const auto lower = LatencyHistogram::lower_bound(i);
+        const auto upper = i + 1 < LatencyHistogram::size ? LatencyHistogram::lower_bound(i + 1) : lower;
+        total += histogram.counts[i] * (lower + upper) / 2.0;
+        count += histogram.counts[i];
+    }
+
+    return count == 0 ? 0.0 : total / count / 1000.0;
+}
+
+}  // namespace
+
+auto stats_json(const Settings &settings,
+                const Results &results,
+                const int games_restored,
+                const std::chrono::duration<double> elapsed) -> std::string {
+    nlohmann::ordered_json json;
+
+    const auto seconds = elapsed.count();
+    json["games_started"] = results.games_started;
+    json["games_played"] = results.games_played;
+    json["elapsed"] = seconds;
+    json["games_per_second"] = seconds > 0.0 ? (results.games_played - games_restored) / seconds : 0.0;
+    json["black_wins"] = results.black_wins;
+    json["white_wins"] = results.white_wins;
+    json["draws"] = results.draws;
+
+    // Results against every opponent, so the Elo is relative to the rest of the field
+    auto &engines = json["engines"];
+    engines = nlohmann::ordered_json::object();
+    for (const auto &engine : settings.engines) {
+        const auto score = results.scores.find(engine.name);
+        const auto latencies = results.latencies.find(engine.name);
+        auto &val = engines[engine.name];
+
+        if (score != results.scores.end()) {
+            const auto &[w, d, l, crashes, played] = score->second;
+            val["wins"] = w;
+            val["losses"] = l;
+            val["draws"] = d;
+            val["played"] = played;
+            val["crashes"] = crashes;
+            val["elo"] = get_elo(w, l, d);
+            val["elo_error"] = get_err(w, l, d);
+        }
+
+        if (latencies != results.latencies.end()) {
+            val["first_reply_ms"] = mean_ms(latencies->second.first_reply);
+            val["move_ms"] = mean_ms(latencies->second.move);
+        }
+    }
+
+    // SPRT is only between the first two engines
+    if (settings.sprt.enabled && settings.engines.size() == 2) {
+        json["sprt"] = {
+            {"llr", match_llr(settings, results)},
+            {"lbound", sprt::get_lbound(settings.sprt.alpha, settings.sprt.beta)},
+            {"ubound", sprt::get_ubound(settings.sprt.alpha, settings.sprt.beta)},
+            {"pentanomial", results.pentanomial},
+        };
+    }
+
+    return json.dump();
+}
+
+#ifndef _WIN32
+
+StatsServer::StatsServer(const std::string &path,
+                         const std::chrono::milliseconds interval,
+                         std::function<std::string()> make_stats)
+    : m_path(path), m_interval(interval), m_make_stats(std::move(make_stats)) {
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        throw std::invalid_argument("Invalid stats socket path");
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    // Only a socket left behind by an earlier match that didn't exit cleanly is removed, anything else at the path is
+    // far more likely to be a mistake in the settings than something we want to delete
+    struct stat info;
+    if (lstat(path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            throw std::invalid_argument("Stats socket path " + path + " already exists and isn't a socket");
+        }
+        unlink(path.c_str());
+    }
+
+    if (pipe(m_wake) < 0) {
+        throw std::system_error(errno, std::generic_category(), "pipe");
+    }
+
+    m_listen = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listen < 0) {
+        const auto err = errno;
+        close(m_wake[0]);
+        close(m_wake[1]);
+        throw std::system_error(err, std::generic_category(), "socket");
+    }
+
+    if (bind(m_listen, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) < 0 || listen(m_listen, 16) < 0) {
+        const auto err = errno;
+        close(m_listen);
+        close(m_wake[0]);
+        close(m_wake[1]);
+        throw std::system_error(err, std::generic_category(), "Stats socket " + path);
+    }
+
+    m_thread = std::thread(&StatsServer::run, this);
+}
+
+StatsServer::~StatsServer() {
+    const char c = 0;
+    [[maybe_unused]] const auto written = write(m_wake[1], &c, 1);
+    m_thread.join();
+
+    close(m_listen);
+    close(m_wake[0]);
+    close(m_wake[1]);
+    unlink(m_path.c_str());
+}
+
+auto StatsServer::run() -> void {
+    std::string stats;
+    std::optional<std::chrono::steady_clock::time_point> last_update;
+
+    while (true) {
+        pollfd fds[2] = {{m_listen, POLLIN, 0}, {m_wake[0], POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        // Time to stop
+        if (fds[1].revents) {
+            return;
+        }
+
+        if (!(fds[0].revents & POLLIN)) {
+            continue;
+        }
+
+        const auto client = accept(m_listen, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (!last_update || now - *last_update >= m_interval) {
+            try {
+                stats = m_make_stats();
+            } catch (...) {
+                stats = "{}";
+            }
+            last_update = now;
+        }
+
+        serve(client, stats);
+        close(client);
+    }
+}
+
+auto StatsServer::serve(const int client, const std::string &stats) -> void {
+    // See if the client is talking HTTP
+    char request[512];
+    std::size_t request_size = 0;
+    pollfd fd = {client, POLLIN, 0};
+    if (poll(&fd, 1, request_timeout_ms) > 0) {
+        const auto num_read = read(client, request, sizeof(request));
+        request_size = num_read > 0 ? static_cast<std::size_t>(num_read) : 0;
+    }
+
+    std::string reply;
+    if (std::string_view(request, request_size).starts_with("GET ")) {
+        reply = "HTTP/1.0 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+                std::to_string(stats.size()) + "\r\nConnection: close\r\n\r\n";
+    }
+    reply += stats;
+
+#ifdef MSG_NOSIGNAL
+    constexpr int flags = MSG_NOSIGNAL;
+#else
+    constexpr int flags = 0;
+#endif
+
+    // Give up on clients that went away
+    std::size_t sent = 0;
+    while (sent < reply.size()) {
+        const auto n = send(client, reply.data() + sent, reply.size() - sent, flags);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n <= 0) {
+            return;
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+}
+
+#else
+
+StatsServer::StatsServer(const std::string &, const std::chrono::milliseconds, std::function<std::string()>) {
+    throw std::runtime_error("The stats server isn't supported on Windows");
+}
+
+StatsServer::~StatsServer() {
+}
+
+auto StatsServer::run() -> void {
+}
+
+auto StatsServer::serve(const int, const std::string &) -> void {
+}
+
+#endif
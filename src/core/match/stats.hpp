@@ -0,0 +1,48 @@
+#ifndef MATCH_STATS_HPP
+#define MATCH_STATS_HPP
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+class Settings;
+class Results;
+
+// The state of a running match as JSON, for anything that wants to keep an eye on it
+// Games per second only counts the games played in the last elapsed seconds, not those restored from a checkpoint
+[[nodiscard]] auto stats_json(const Settings &settings,
+                              const Results &results,
+                              const int games_restored,
+                              const std::chrono::duration<double> elapsed) -> std::string;
+
+// Serve statistics on a Unix socket from a thread of its own
+// Each client that connects is sent the statistics and disconnected, with HTTP headers if it asked with a GET
+// request, so both "nc -U" and "curl --unix-socket" work
+// The statistics are only rebuilt when someone asks for them, and at most once per interval, so the games being
+// played never have to wait for us
+class StatsServer {
+   public:
+    [[nodiscard]] StatsServer(const std::string &path,
+                              const std::chrono::milliseconds interval,
+                              std::function<std::string()> make_stats);
+
+    ~StatsServer();
+
+    StatsServer(const StatsServer &) = delete;
+    auto operator=(const StatsServer &) -> StatsServer & = delete;
+
+   private:
+    auto run() -> void;
+
+    auto serve(const int client, const std::string &stats) -> void;
+
+    std::string m_path;
+    std::chrono::milliseconds m_interval;
+    std::function<std::string()> m_make_stats;
+    int m_listen = -1;
+    int m_wake[2] = {-1, -1};
+    std::thread m_thread;
+};
+
+#endif
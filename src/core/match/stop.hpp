@@ -0,0 +1,39 @@
+#ifndef MATCH_STOP_HPP
+#define MATCH_STOP_HPP
+
+#include <atomic>
+
+// Shared by everything playing games in a match, so that they all stop as soon as one of them decides the match is
+// over rather than each finding out for itself after its next game
+class StopToken {
+   public:
+    // Don't start any more games, but finish those already being played and the pairs they belong to
+    auto finish() noexcept -> void {
+        m_finishing.store(true, std::memory_order_relaxed);
+    }
+
+    // Stop the games being played as well, without waiting for them to finish
+    auto abort() noexcept -> void {
+        m_finishing.store(true, std::memory_order_relaxed);
+        m_aborted.store(true, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto is_finishing() const noexcept -> bool {
+        return m_finishing.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto is_aborted() const noexcept -> bool {
+        return m_aborted.load(std::memory_order_relaxed);
+    }
+
+    // For engines to watch while waiting on a reply, so they can be stopped part way through a search
+    [[nodiscard]] auto aborted_flag() const noexcept -> const std::atomic<bool> * {
+        return &m_aborted;
+    }
+
+   private:
+    std::atomic<bool> m_finishing = false;
+    std::atomic<bool> m_aborted = false;
+};
+
+#endif
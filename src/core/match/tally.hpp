@@ -0,0 +1,323 @@
+#ifndef MATCH_TALLY_HPP
+#define MATCH_TALLY_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <libataxx/position.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../play.hpp"
+#include "results.hpp"
+
+// Per-worker result counters
+// Every worker only ever writes to its own block of counters and readers sum all of them,
+// so recording the result of a game doesn't need a lock
+class [[nodiscard]] ResultsTally {
+   public:
+    ResultsTally(const std::vector<std::string> &names, const std::size_t num_workers, const std::size_t num_games = 0)
+        : m_names(names),
+          m_num_workers(num_workers),
+          m_stride(padded(Counter::Engines + names.size() * EngineCounter::Size)),
+          m_counters(std::make_unique<std::atomic<int>[]>(num_workers * m_stride)),
+          m_num_games(static_cast<int>(num_games)),
+          m_num_pairs(names.size() == 2 ? num_games / 2 : 0),
+          m_pairs(std::make_unique<std::atomic<std::uint8_t>[]>(m_num_pairs)) {
+        for (std::size_t i = 0; i < num_workers * m_stride; ++i) {
+            m_counters[i].store(0, std::memory_order_relaxed);
+        }
+        for (std::size_t i = 0; i < m_num_pairs; ++i) {
+            m_pairs[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    auto started(const std::size_t worker) noexcept -> void {
+        add(worker, Counter::GamesStarted);
+    }
+
+    // The game was abandoned before it finished, so it's as if it never started
+    auto aborted(const std::size_t worker) noexcept -> void {
+        add(worker, Counter::GamesStarted, -1);
+    }
+
+    auto played(const std::size_t worker,
+                const std::size_t engine1,
+                const std::size_t engine2,
+                const libataxx::Result result,
+                const ResultReason reason) noexcept -> void {
+        assert(engine1 < m_names.size());
+        assert(engine2 < m_names.size());
+
+        add_engine(worker, engine1, EngineCounter::Played);
+        add_engine(worker, engine2, EngineCounter::Played);
+
+        switch (result) {
+            case libataxx::Result::BlackWin:
+                add_engine(worker, engine1, EngineCounter::Wins);
+                add_engine(worker, engine2, EngineCounter::Losses);
+                add(worker, Counter::BlackWins);
+                break;
+            case libataxx::Result::WhiteWin:
+                add_engine(worker, engine1, EngineCounter::Losses);
+                add_engine(worker, engine2, EngineCounter::Wins);
+                add(worker, Counter::WhiteWins);
+                break;
+            case libataxx::Result::Draw:
+                add_engine(worker, engine1, EngineCounter::Draws);
+                add_engine(worker, engine2, EngineCounter::Draws);
+                add(worker, Counter::Draws);
+                break;
+            default:
+                break;
+        }
+
+        // The engine that crashed is the one that lost
+        if (reason == ResultReason::EngineCrash) {
+            const auto crashed = result == libataxx::Result::BlackWin ? engine2 : engine1;
+            add_engine(worker, crashed, EngineCounter::Crashes);
+        }
+
+        // Counted last so that anyone who sees the game as played also sees its result
+        add(worker, Counter::GamesPlayed, std::memory_order_release);
+    }
+
+    // Games 2n and 2n+1 are played from the same opening with colours reversed, and are scored together
+    // Whichever game finishes second scores the pair, without either of them waiting on the other
+    auto paired(const std::size_t worker,
+                const std::size_t game,
+                const std::size_t engine1,
+                const libataxx::Result result) noexcept -> void {
+        if (game / 2 >= m_num_pairs) {
+            return;
+        }
+
+        // Half points scored by the first engine, stored plus one so that zero means the game hasn't finished
+        const auto points = pair_points(engine1, result);
+        const auto other = m_pairs[game / 2].exchange(static_cast<std::uint8_t>(points + 1), std::memory_order_acq_rel);
+        if (other != 0) {
+            add(worker, Counter::Pairs + points + other - 1);
+        }
+    }
+
+    [[nodiscard]] static constexpr auto pair_points(const std::size_t engine1, const libataxx::Result result) noexcept
+        -> int {
+        switch (result) {
+            case libataxx::Result::BlackWin:
+                return engine1 == 0 ? 2 : 0;
+            case libataxx::Result::WhiteWin:
+                return engine1 == 0 ? 0 : 2;
+            default:
+                return 1;
+        }
+    }
+
+    auto moved(const std::size_t worker,
+               const std::size_t engine,
+               const std::int64_t first_reply_us,
+               const std::int64_t total_us) noexcept -> void {
+        assert(engine < m_names.size());
+        add_engine(worker, engine, EngineCounter::FirstReply + LatencyHistogram::bucket(first_reply_us));
+        add_engine(worker, engine, EngineCounter::Move + LatencyHistogram::bucket(total_us));
+    }
+
+    // Count the games from an earlier run as if the first worker had played them
+    // Pairs that only had one game finished are given the points it scored
+    auto restore(const Results &results, const std::map<std::size_t, int> &half_pairs = {}) -> void {
+        for (std::size_t i = 0; i < results.pentanomial.size(); ++i) {
+            add(0, Counter::Pairs + i, results.pentanomial[i]);
+        }
+        for (const auto &[pair, points] : half_pairs) {
+            if (pair < m_num_pairs) {
+                m_pairs[pair].store(static_cast<std::uint8_t>(points + 1), std::memory_order_relaxed);
+            }
+        }
+
+        add(0, Counter::GamesStarted, results.games_played);
+        add(0, Counter::GamesPlayed, results.games_played);
+        add(0, Counter::BlackWins, results.black_wins);
+        add(0, Counter::WhiteWins, results.white_wins);
+        add(0, Counter::Draws, results.draws);
+
+        for (std::size_t engine = 0; engine < m_names.size(); ++engine) {
+            const auto score = results.scores.find(m_names[engine]);
+            if (score != results.scores.end()) {
+                add_engine(0, engine, EngineCounter::Wins, score->second.wins);
+                add_engine(0, engine, EngineCounter::Draws, score->second.draws);
+                add_engine(0, engine, EngineCounter::Losses, score->second.losses);
+                add_engine(0, engine, EngineCounter::Crashes, score->second.crashes);
+                add_engine(0, engine, EngineCounter::Played, score->second.played);
+            }
+
+            const auto latencies = results.latencies.find(m_names[engine]);
+            if (latencies != results.latencies.end()) {
+                for (std::size_t i = 0; i < LatencyHistogram::size; ++i) {
+                    add_engine(0, engine, EngineCounter::FirstReply + i, latencies->second.first_reply.counts[i]);
+                    add_engine(0, engine, EngineCounter::Move + i, latencies->second.move.counts[i]);
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] auto snapshot() const -> Results {
+        Results results;
+
+        for (const auto &name : m_names) {
+            results.scores[name];
+            results.latencies[name];
+        }
+
+        for (std::size_t worker = 0; worker < m_num_workers; ++worker) {
+            results.games_played += get(worker, Counter::GamesPlayed, std::memory_order_acquire);
+            results.games_started += get(worker, Counter::GamesStarted);
+            results.black_wins += get(worker, Counter::BlackWins);
+            results.white_wins += get(worker, Counter::WhiteWins);
+            results.draws += get(worker, Counter::Draws);
+            for (std::size_t i = 0; i < results.pentanomial.size(); ++i) {
+                results.pentanomial[i] += get(worker, Counter::Pairs + i);
+            }
+
+            for (std::size_t engine = 0; engine < m_names.size(); ++engine) {
+                auto &score = results.scores[m_names[engine]];
+                score.wins += get_engine(worker, engine, EngineCounter::Wins);
+                score.draws += get_engine(worker, engine, EngineCounter::Draws);
+                score.losses += get_engine(worker, engine, EngineCounter::Losses);
+                score.crashes += get_engine(worker, engine, EngineCounter::Crashes);
+                score.played += get_engine(worker, engine, EngineCounter::Played);
+
+                auto &latencies = results.latencies[m_names[engine]];
+                for (std::size_t i = 0; i < LatencyHistogram::size; ++i) {
+                    latencies.first_reply.counts[i] += get_engine(worker, engine, EngineCounter::FirstReply + i);
+                    latencies.move.counts[i] += get_engine(worker, engine, EngineCounter::Move + i);
+                }
+            }
+        }
+
+        return results;
+    }
+
+    // Much cheaper than a full snapshot when only the count is needed
+    [[nodiscard]] auto games_played() const noexcept -> int {
+        int games_played = 0;
+        for (std::size_t worker = 0; worker < m_num_workers; ++worker) {
+            games_played += get(worker, Counter::GamesPlayed, std::memory_order_acquire);
+        }
+        return games_played;
+    }
+
+    // Whether the results are due to be passed on, which is every interval games and once the last game is played
+    // Only one of the games finishing at the same time is told yes, so the full snapshot isn't built for every game
+    [[nodiscard]] auto is_update_due(const int games_played, const int interval) noexcept -> bool {
+        assert(interval > 0);
+        auto last = m_last_update.load(std::memory_order_relaxed);
+        while (games_played / interval > last / interval || (games_played == m_num_games && last != m_num_games)) {
+            if (m_last_update.compare_exchange_weak(last, games_played, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Only what the SPRT needs, the first engine's score and the game pairs
+    // Much cheaper than a full snapshot, so it can be checked after every game
+    [[nodiscard]] auto sprt_snapshot() const -> Results {
+        Results results;
+        if (m_names.empty()) {
+            return results;
+        }
+
+        auto &score = results.scores[m_names[0]];
+        for (std::size_t worker = 0; worker < m_num_workers; ++worker) {
+            for (std::size_t i = 0; i < results.pentanomial.size(); ++i) {
+                results.pentanomial[i] += get(worker, Counter::Pairs + i);
+            }
+            score.wins += get_engine(worker, 0, EngineCounter::Wins);
+            score.draws += get_engine(worker, 0, EngineCounter::Draws);
+            score.losses += get_engine(worker, 0, EngineCounter::Losses);
+        }
+
+        return results;
+    }
+
+   private:
+    struct Counter {
+        enum : std::size_t
+        {
+            GamesStarted = 0,
+            GamesPlayed,
+            BlackWins,
+            WhiteWins,
+            Draws,
+            Pairs,
+            Engines = Pairs + 5,
+        };
+    };
+
+    struct EngineCounter {
+        enum : std::size_t
+        {
+            Wins = 0,
+            Draws,
+            Losses,
+            Crashes,
+            Played,
+            FirstReply,
+            Move = FirstReply + LatencyHistogram::size,
+            Size = Move + LatencyHistogram::size,
+        };
+    };
+
+    // Keep each worker's counters on their own cache lines
+    [[nodiscard]] static constexpr auto padded(const std::size_t n) noexcept -> std::size_t {
+        constexpr std::size_t per_line = 64 / sizeof(std::atomic<int>);
+        return (n + per_line - 1) / per_line * per_line;
+    }
+
+    auto add(const std::size_t worker,
+             const std::size_t idx,
+             const std::memory_order order = std::memory_order_relaxed) noexcept -> void {
+        add(worker, idx, 1, order);
+    }
+
+    auto add(const std::size_t worker,
+             const std::size_t idx,
+             const int n,
+             const std::memory_order order = std::memory_order_relaxed) noexcept -> void {
+        assert(worker < m_num_workers);
+        m_counters[worker * m_stride + idx].fetch_add(n, order);
+    }
+
+    auto add_engine(const std::size_t worker,
+                    const std::size_t engine,
+                    const std::size_t counter,
+                    const int n = 1) noexcept -> void {
+        add(worker, Counter::Engines + engine * EngineCounter::Size + counter, n);
+    }
+
+    [[nodiscard]] auto get(const std::size_t worker,
+                           const std::size_t idx,
+                           const std::memory_order order = std::memory_order_relaxed) const noexcept -> int {
+        return m_counters[worker * m_stride + idx].load(order);
+    }
+
+    [[nodiscard]] auto get_engine(const std::size_t worker,
+                                  const std::size_t engine,
+                                  const std::size_t counter) const noexcept -> int {
+        return get(worker, Counter::Engines + engine * EngineCounter::Size + counter);
+    }
+
+    std::vector<std::string> m_names;
+    std::size_t m_num_workers = 0;
+    std::size_t m_stride = 0;
+    std::unique_ptr<std::atomic<int>[]> m_counters;
+    int m_num_games = 0;
+    // The number of games played when the results were last passed on
+    std::atomic<int> m_last_update = 0;
+    // The first engine's score in each pair's first finished game, shared by every worker
+    std::size_t m_num_pairs = 0;
+    std::unique_ptr<std::atomic<std::uint8_t>[]> m_pairs;
+};
+
+#endif
@@ -1,77 +1,229 @@
 #include "worker.hpp"
+#include <algorithm>
 #include <elo.hpp>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <sprt.hpp>
 #include <thread>
-#include "../cache.hpp"
+#include "../opening_book.hpp"
 #include "../play.hpp"
+#include "cores.hpp"
+#include "game_writer.hpp"
+#include "llr.hpp"
+#include "resources.hpp"
 #include "results.hpp"
 #include "settings.hpp"
+#include "stop.hpp"
+#include "tally.hpp"
 // Engines
 #include "../engine/create.hpp"
 #include "../engine/engine.hpp"
+#include "../engine/pool.hpp"
 // Tournaments
 #include "../tournament/generator.hpp"
-#include "../tournament/roundrobin.hpp"
 
 std::mutex mtx_output;
-std::mutex mtx_games;
-
-void worker(const Settings &settings,
-            const std::vector<std::string> &openings,
-            std::shared_ptr<TournamentGenerator> game_generator,
-            Results &results,
-            const Callbacks &callbacks) {
-    auto should_stop = false;
-    GameInfo game_info;
-    Cache<int, std::shared_ptr<Engine>> engine_cache(2);
-
-    while (!should_stop) {
-        {
-            std::lock_guard<std::mutex> lock(mtx_games);
-
-            // Return if we're out of things to do
-            if (game_generator->is_finished()) {
-                return;
-            }
 
-            // Get the next game to play
-            game_info = game_generator->next();
+auto claim_game(const MatchContext &context, std::atomic<std::size_t> &next_game, const StopToken &stop)
+    -> std::optional<GameInfo> {
+    auto idx = next_game.load(std::memory_order_relaxed);
 
-            results.games_started++;
+    while (idx < context.game_generator.expected()) {
+        const auto game_info = context.game_generator.game_at(idx);
+
+        // Pairs are an even game and the odd one after it, with the same opening and colours reversed
+        // Games are claimed in order, so the first game of an odd game's pair is already being played
+        const auto is_second = context.settings.engines.size() == 2 && game_info.id % 2 == 1;
+        if (stop.is_aborted() || (stop.is_finishing() && !is_second)) {
+            return std::nullopt;
         }
 
-        const auto game = GameSettings(openings[game_info.idx_opening],
-                                       settings.engines[game_info.idx_player1],
-                                       settings.engines[game_info.idx_player2]);
+        if (next_game.compare_exchange_weak(idx, idx + 1, std::memory_order_relaxed)) {
+            return game_info;
+        }
+    }
 
-        callbacks.on_game_started(0, game.engine1.name, game.engine2.name);
+    return std::nullopt;
+}
+
+auto get_engine(EnginePool &engine_pool, const EngineSettings &settings, const Callbacks &callbacks)
+    -> std::shared_ptr<Engine> {
+    // Reuse idle engines if there are any
+    auto engine = engine_pool.try_acquire(settings.id);
+
+    // Create a new engine process if necessary, the pool frees up resources by removing idle engines
+    if (!engine) {
+        callbacks.on_engine_start(settings.name);
+        engine = engine_pool.create(settings, callbacks.on_info_send, callbacks.on_info_recv);
+    }
+
+    return engine;
+}
+
+auto pin_engines(const MatchContext &context,
+                 const std::size_t id,
+                 const GameSettings &game,
+                 Engine &engine1,
+                 Engine &engine2) -> void {
+    if (id >= context.slot_cores.size()) {
+        return;
+    }
+
+    // Engines from the pool may have been pinned somewhere else by the last game they played
+    const auto [cores1, cores2] = split_cores(context.slot_cores[id], game.engine1, game.engine2);
+    engine1.set_affinity(cores1);
+    engine2.set_affinity(cores2);
+}
+
+auto return_engines(EnginePool &engine_pool,
+                    const GameSettings &game,
+                    std::shared_ptr<Engine> engine1,
+                    std::shared_ptr<Engine> engine2,
+                    const bool engines_okay) -> void {
+    // Hand the engines back for someone else to use, unless they might be broken
+    // Engines that stopped responding are killed and replaced next time they're needed
+    if (engines_okay && !engine1->is_broken()) {
+        engine_pool.release(game.engine1.id, std::move(engine1));
+    } else {
+        engine_pool.discard(std::move(engine1));
+    }
+
+    if (engines_okay && !engine2->is_broken()) {
+        engine_pool.release(game.engine2.id, std::move(engine2));
+    } else {
+        engine_pool.discard(std::move(engine2));
+    }
+}
+
+auto is_sprt_stop(const Settings &settings, const Results &results) -> bool {
+    if (!settings.sprt.enabled || !settings.sprt.autostop || settings.engines.size() != 2) {
+        return false;
+    }
+
+    const auto llr = match_llr(settings, results);
+    const auto lbound = sprt::get_lbound(settings.sprt.alpha, settings.sprt.beta);
+    const auto ubound = sprt::get_ubound(settings.sprt.alpha, settings.sprt.beta);
+
+    return llr <= lbound || llr >= ubound;
+}
+
+auto record_game(const std::size_t id,
+                 const MatchContext &context,
+                 const GameInfo &game_info,
+                 const GameSettings &game,
+                 const GameThingy &game_data,
+                 ResultsTally &tally,
+                 StopToken &stop,
+                 GameWriter *game_writer) -> void {
+    // Played again if the match is resumed
+    if (game_data.reason == ResultReason::Aborted) {
+        tally.aborted(id);
+        return;
+    }
+
+    context.callbacks.on_game_finished(0, game.engine1.name, game.engine2.name);
 
-        // If the engines we need aren't in the cache, we get nothing
-        auto engine1 = engine_cache.get(game.engine1.id);
-        auto engine2 = engine_cache.get(game.engine2.id);
+    // Move timings
+    auto is_black = game_data.startpos.get_turn() == libataxx::Side::Black;
+    for (const auto &move : game_data.history) {
+        const auto engine = is_black ? game_info.idx_player1 : game_info.idx_player2;
+        tally.moved(id, engine, move.first_reply_us, move.total_us);
+        is_black = !is_black;
+    }
+
+    // Results
+    tally.played(id, game_info.idx_player1, game_info.idx_player2, game_data.result, game_data.reason);
+    tally.paired(id, game_info.id, game_info.idx_player1, game_data.result);
+
+    // Decided without waiting for the lock, which is only needed for printing
+    const auto is_stopping = is_sprt_stop(context.settings, tally.sprt_snapshot());
+    if (is_stopping) {
+        if (context.settings.sprt.abort) {
+            stop.abort();
+        } else {
+            stop.finish();
+        }
+    }
+
+    // Write to .pgn and binary files
+    if (game_writer) {
+        game_writer->push(game_info, game_data);
+    }
+
+    // Building the full results is far slower than playing a game between builtin engines, so only do it when there's
+    // something to print: every game before the first rating interval if we're printing early, then once per interval
+    const auto games_played = tally.games_played();
+    const auto interval = std::max(context.settings.ratinginterval, 1);
+    const auto is_early = context.settings.print_early && games_played < interval;
+    if (!tally.is_update_due(games_played, interval) && !is_early && !is_stopping) {
+        return;
+    }
 
-        // Free resources by removing any engine processes left in the cache
-        engine_cache.clear();
+    // Printing
+    std::lock_guard<std::mutex> lock(mtx_output);
 
-        // Create new engine processes if necessary, knowing we have the resources available
-        if (!engine1) {
-            callbacks.on_engine_start(game.engine1.name);
-            engine1 = make_engine(game.engine1, callbacks.on_info_send, callbacks.on_info_recv);
+    const auto results = tally.snapshot();
+
+    assert(results.games_played <= results.games_started);
+
+    context.callbacks.on_results_update(results);
+}
+
+void worker(const std::size_t id,
+            const MatchContext &context,
+            std::atomic<std::size_t> &next_game,
+            StopToken &stop,
+            EnginePool &engine_pool,
+            ResultsTally &tally,
+            ResourceBudget *budget,
+            GameWriter *game_writer) {
+    const auto &settings = context.settings;
+    const auto &callbacks = context.callbacks;
+
+    // Only watched by the engines if they're to be stopped mid-search
+    const auto *const abort = settings.sprt.abort ? stop.aborted_flag() : nullptr;
+
+    while (true) {
+        // Return if we're out of things to do
+        const auto claimed = claim_game(context, next_game, stop);
+        if (!claimed) {
+            return;
         }
 
-        if (!engine2) {
-            callbacks.on_engine_start(game.engine2.name);
-            engine2 = make_engine(game.engine2, callbacks.on_info_send, callbacks.on_info_recv);
+        const auto &game_info = *claimed;
+
+        const auto game = GameSettings{context.openings.position(game_info.idx_opening),
+                                       settings.engines[game_info.idx_player1],
+                                       settings.engines[game_info.idx_player2]};
+
+        // Wait for the games already running to make room for this one
+        const auto resources = game_resources(game.engine1, game.engine2);
+        if (budget) {
+            budget->acquire(resources);
+
+            // The match might have been stopped while we were waiting
+            if (stop.is_aborted()) {
+                budget->release(resources);
+                return;
+            }
         }
 
+        tally.started(id);
+
+        callbacks.on_game_started(0, game.engine1.name, game.engine2.name);
+
+        auto engine1 = get_engine(engine_pool, game.engine1, callbacks);
+        auto engine2 = get_engine(engine_pool, game.engine2, callbacks);
+        pin_engines(context, id, game, *engine1, *engine2);
+
         GameThingy game_data;
+        auto engines_okay = false;
 
         // Play the game
         try {
-            game_data = play(settings.adjudication, game, *engine1, *engine2);
+            game_data = play(settings.adjudication, game, engine1, engine2, abort);
+            engines_okay = game_data.reason != ResultReason::EngineCrash;
         } catch (std::invalid_argument &e) {
             std::cerr << e.what() << "\n";
         } catch (const char *e) {
@@ -82,71 +234,12 @@ void worker(const Settings &settings,
             std::cerr << "Error woops\n";
         }
 
-        engine_cache.push(game.engine1.id, *engine1);
-        engine_cache.push(game.engine2.id, *engine2);
-
-        (*engine1).reset();
-        (*engine2).reset();
-
-        callbacks.on_game_finished(0, game.engine1.name, game.engine2.name);
-
-        // Results & printing
-        {
-            std::lock_guard<std::mutex> lock(mtx_output);
-
-            results.games_played++;
-
-            assert(results.games_played <= results.games_started);
-
-            // Update engine results
-            results.scores[game.engine1.name].played++;
-            results.scores[game.engine2.name].played++;
-
-            switch (game_data.result) {
-                case libataxx::Result::BlackWin:
-                    results.scores[game.engine1.name].wins++;
-                    results.scores[game.engine2.name].losses++;
-                    results.black_wins++;
-                    break;
-                case libataxx::Result::WhiteWin:
-                    results.scores[game.engine1.name].losses++;
-                    results.scores[game.engine2.name].wins++;
-                    results.white_wins++;
-                    break;
-                case libataxx::Result::Draw:
-                    results.scores[game.engine1.name].draws++;
-                    results.scores[game.engine2.name].draws++;
-                    results.draws++;
-                    break;
-                default:
-                    break;
-            }
+        return_engines(engine_pool, game, std::move(engine1), std::move(engine2), engines_okay);
 
-            // Write to .pgn
-            if (settings.pgn.enabled && !settings.pgn.path.empty()) {
-                write_as_pgn(settings.pgn, game.engine1.name, game.engine2.name, game_data);
-            }
-
-            // Check SPRT stop
-            const auto is_sprt_stop = [&settings, &results, &game]() {
-                if (!settings.sprt.enabled || !settings.sprt.autostop || settings.engines.size() != 2) {
-                    return false;
-                }
-
-                const auto w = results.scores.at(settings.engines.at(0).name).wins;
-                const auto l = results.scores.at(settings.engines.at(0).name).losses;
-                const auto d = results.scores.at(settings.engines.at(0).name).draws;
-                const auto llr = sprt::get_llr(w, l, d, settings.sprt.elo0, settings.sprt.elo1);
-                const auto lbound = sprt::get_lbound(settings.sprt.alpha, settings.sprt.beta);
-                const auto ubound = sprt::get_ubound(settings.sprt.alpha, settings.sprt.beta);
-
-                return llr <= lbound || llr >= ubound;
-            }();
-
-            // Stop the match
-            should_stop |= is_sprt_stop;
-
-            callbacks.on_results_update(results);
+        if (budget) {
+            budget->release(resources);
         }
+
+        record_game(id, context, game_info, game, game_data, tally, stop, game_writer);
     }
 }
@@ -1,20 +1,73 @@
 #ifndef MATCH_WORKER_HPP
 #define MATCH_WORKER_HPP
 
+#include <atomic>
+#include <cstddef>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include "../tournament/generator.hpp"
 #include "callbacks.hpp"
+#include "context.hpp"
 
 class Settings;
-class Results;
+class EnginePool;
+class ResultsTally;
+class GameWriter;
+class ResourceBudget;
+class StopToken;
 class GameSettings;
+class GameThingy;
+class Engine;
+class EngineSettings;
+class Results;
+
+// Claim the next game to play, unless there are none left that should be played
+// Once the match is stopping, only the second game of a pair that's already been claimed is worth finishing
+[[nodiscard]] auto claim_game(const MatchContext &context, std::atomic<std::size_t> &next_game, const StopToken &stop)
+    -> std::optional<GameInfo>;
+
+// Take an idle engine from the pool, or start a new one
+[[nodiscard]] auto get_engine(EnginePool &engine_pool, const EngineSettings &settings, const Callbacks &callbacks)
+    -> std::shared_ptr<Engine>;
+
+// Move the engines onto the cores belonging to the game slot, if engines are being pinned
+auto pin_engines(const MatchContext &context,
+                 const std::size_t id,
+                 const GameSettings &game,
+                 Engine &engine1,
+                 Engine &engine2) -> void;
+
+auto return_engines(EnginePool &engine_pool,
+                    const GameSettings &game,
+                    std::shared_ptr<Engine> engine1,
+                    std::shared_ptr<Engine> engine2,
+                    const bool engines_okay) -> void;
+
+// Whether the SPRT has reached a conclusion and the match should stop
+[[nodiscard]] auto is_sprt_stop(const Settings &settings, const Results &results) -> bool;
+
+// Record the result of a finished game, and tell everyone else to stop if that ends the match
+// Aborted games aren't recorded
+auto record_game(const std::size_t id,
+                 const MatchContext &context,
+                 const GameInfo &game_info,
+                 const GameSettings &game,
+                 const GameThingy &game_data,
+                 ResultsTally &tally,
+                 StopToken &stop,
+                 GameWriter *game_writer) -> void;
 
-void worker(const Settings &settings,
-            const std::vector<std::string> &openings,
-            std::shared_ptr<TournamentGenerator> game_generator,
-            Results &results,
-            const Callbacks &callbacks);
+// Play games one at a time until there are none left
+// Games only start once there's room for them in the budget, if there is one
+void worker(const std::size_t id,
+            const MatchContext &context,
+            std::atomic<std::size_t> &next_game,
+            StopToken &stop,
+            EnginePool &engine_pool,
+            ResultsTally &tally,
+            ResourceBudget *budget,
+            GameWriter *game_writer);
 
 #endif
@@ -0,0 +1,319 @@
+#include "opening_book.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include "ataxx/symmetry.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr std::string_view default_book = "x5o/7/7/7/7/7/o5x x 0 1\n";
+constexpr std::string_view index_magic = "CAXI";
+// Small books aren't worth starting threads for
+constexpr std::size_t min_lines_per_thread = 10000;
+
+struct IndexHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t book_size;
+    std::int64_t book_time;
+    std::uint64_t num_lines;
+};
+
+[[nodiscard]] auto book_time(const std::string &path) -> std::int64_t {
+    return std::filesystem::last_write_time(path).time_since_epoch().count();
+}
+
+// Large books are split between threads, each taking a contiguous range of lines
+[[nodiscard]] auto num_threads(const std::size_t num_lines) -> std::size_t {
+    return std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, 1 + num_lines / min_lines_per_thread);
+}
+
+// Calls f(n, begin, end) for the nth range of lines, the ranges are in order
+template <typename F>
+auto for_each_range(const std::size_t num_lines, F f) -> void {
+    const auto n_threads = num_threads(num_lines);
+    const auto lines_per_thread = (num_lines + n_threads - 1) / n_threads;
+
+    const auto run = [&f, num_lines, lines_per_thread](const std::size_t n) {
+        f(n, n * lines_per_thread, std::min(num_lines, (n + 1) * lines_per_thread));
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t n = 1; n < n_threads; ++n) {
+        threads.emplace_back(run, n);
+    }
+    run(0);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+}  // namespace
+
+OpeningBook::OpeningBook() : m_data(default_book.data()), m_size(default_book.size()) {
+    build_index();
+    parse_positions();
+}
+
+OpeningBook::OpeningBook(const std::string &path, const bool cache_index) {
+#ifndef _WIN32
+    const auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::invalid_argument("Could not open openings file " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not read openings file " + path);
+    }
+
+    m_size = static_cast<std::size_t>(st.st_size);
+    if (m_size > 0) {
+        auto *const data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Could not map openings file " + path);
+        }
+        ::madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char *>(data);
+        m_mapped = true;
+    }
+    ::close(fd);
+#else
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open()) {
+        throw std::invalid_argument("Could not open openings file " + path);
+    }
+    m_contents.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    m_data = m_contents.data();
+    m_size = m_contents.size();
+#endif
+
+    try {
+        if (!cache_index || !load_index(path)) {
+            build_index();
+            if (cache_index) {
+                save_index(path);
+            }
+        }
+
+        parse_positions();
+    } catch (...) {
+        // The destructor won't run, so don't leave the file mapped
+        release();
+        throw;
+    }
+}
+
+OpeningBook::OpeningBook(OpeningBook &&other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)),
+      m_size(std::exchange(other.m_size, 0)),
+      m_mapped(std::exchange(other.m_mapped, false)),
+      m_contents(std::move(other.m_contents)),
+      m_offsets(std::move(other.m_offsets)),
+      m_positions(std::move(other.m_positions)),
+      m_num_duplicates(std::exchange(other.m_num_duplicates, 0)) {
+}
+
+OpeningBook &OpeningBook::operator=(OpeningBook &&other) noexcept {
+    if (this != &other) {
+        release();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_mapped = std::exchange(other.m_mapped, false);
+        m_contents = std::move(other.m_contents);
+        m_offsets = std::move(other.m_offsets);
+        m_positions = std::move(other.m_positions);
+        m_num_duplicates = std::exchange(other.m_num_duplicates, 0);
+    }
+    return *this;
+}
+
+OpeningBook::~OpeningBook() {
+    release();
+}
+
+auto OpeningBook::operator[](const std::size_t idx) const noexcept -> std::string_view {
+    const auto start = m_data + m_offsets[idx];
+    const auto *end = static_cast<const char *>(std::memchr(start, '\n', m_size - m_offsets[idx]));
+    if (!end) {
+        end = m_data + m_size;
+    }
+    if (end > start && end[-1] == '\r') {
+        end--;
+    }
+    return std::string_view(start, static_cast<std::size_t>(end - start));
+}
+
+auto OpeningBook::shuffle(const std::uint32_t seed) -> void {
+    // Shuffle the line numbers rather than the lines, so each position moves with its line
+    // std::shuffle is kept so that a given seed gives the same order it always has
+    std::vector<std::size_t> order(m_offsets.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(seed));
+
+    std::vector<std::uint64_t> offsets(order.size());
+    std::vector<libataxx::Position> positions(order.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        offsets[i] = m_offsets[order[i]];
+        positions[i] = m_positions[order[i]];
+    }
+    m_offsets = std::move(offsets);
+    m_positions = std::move(positions);
+}
+
+auto OpeningBook::deduplicate() -> void {
+    std::vector<std::uint64_t> hashes(m_positions.size());
+    const auto hash_range = [this, &hashes](const std::size_t, const std::size_t begin, const std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            hashes[i] = canonical_hash(m_positions[i]);
+        }
+    };
+    for_each_range(m_positions.size(), hash_range);
+
+    std::unordered_set<std::uint64_t> seen;
+    seen.reserve(m_positions.size());
+
+    // Compact in place, keeping the first of each in its original order
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < m_positions.size(); ++i) {
+        if (seen.insert(hashes[i]).second) {
+            m_offsets[kept] = m_offsets[i];
+            m_positions[kept] = m_positions[i];
+            ++kept;
+        }
+    }
+
+    m_num_duplicates += m_positions.size() - kept;
+    m_offsets.resize(kept);
+    m_positions.resize(kept);
+}
+
+auto OpeningBook::build_index() -> void {
+    const auto min_fen_size = std::string_view("7/7/7/7/7/7/7").size();
+
+    m_offsets.clear();
+
+    std::size_t pos = 0;
+    while (pos < m_size) {
+        const auto *const newline = static_cast<const char *>(std::memchr(m_data + pos, '\n', m_size - pos));
+        const auto end = newline ? static_cast<std::size_t>(newline - m_data) : m_size;
+
+        if (end - pos >= min_fen_size && m_data[pos] != '#') {
+            m_offsets.push_back(pos);
+        }
+
+        pos = end + 1;
+    }
+}
+
+auto OpeningBook::parse_positions() -> void {
+    m_positions.assign(m_offsets.size(), libataxx::Position());
+
+    // The first bad line found by each thread
+    std::vector<std::optional<std::size_t>> errors(num_threads(m_offsets.size()));
+
+    const auto parse_range = [this, &errors](const std::size_t n, const std::size_t begin, const std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            try {
+                m_positions[i] = libataxx::Position(std::string((*this)[i]));
+            } catch (...) {
+                errors[n] = i;
+                return;
+            }
+        }
+    };
+    for_each_range(m_offsets.size(), parse_range);
+
+    // Report the earliest bad line, the ranges are in order
+    for (const auto &error : errors) {
+        if (error) {
+            // Only counted when something's wrong, so the index doesn't have to store line numbers
+            const auto line = std::count(m_data, m_data + m_offsets[*error], '\n') + 1;
+            throw std::invalid_argument("Invalid opening on line " + std::to_string(line) + ": " +
+                                        std::string((*this)[*error]));
+        }
+    }
+}
+
+auto OpeningBook::load_index(const std::string &book_path) -> bool {
+    std::ifstream f(book_path + ".idx", std::ios::binary);
+    if (!f.is_open()) {
+        return false;
+    }
+
+    IndexHeader header;
+    f.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+    if (!f || std::string_view(header.magic, sizeof(header.magic)) != index_magic || header.version != 1 ||
+        header.book_size != m_size || header.book_time != book_time(book_path)) {
+        return false;
+    }
+
+    m_offsets.resize(header.num_lines);
+    f.read(reinterpret_cast<char *>(m_offsets.data()),
+           static_cast<std::streamsize>(m_offsets.size() * sizeof(std::uint64_t)));
+
+    // A truncated index is no good to us
+    if (!f || std::any_of(m_offsets.begin(), m_offsets.end(), [this](const auto n) {
+            return n >= m_size;
+        })) {
+        m_offsets.clear();
+        return false;
+    }
+
+    return true;
+}
+
+auto OpeningBook::save_index(const std::string &book_path) const -> void {
+    IndexHeader header;
+    std::memcpy(header.magic, index_magic.data(), sizeof(header.magic));
+    header.version = 1;
+    header.book_size = m_size;
+    header.book_time = book_time(book_path);
+    header.num_lines = m_offsets.size();
+
+    // Written somewhere else first so other matches never see half an index
+    const auto path = book_path + ".idx";
+    const auto tmp_path = path + ".tmp";
+    {
+        std::ofstream f(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!f.is_open()) {
+            return;
+        }
+        f.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        f.write(reinterpret_cast<const char *>(m_offsets.data()),
+                static_cast<std::streamsize>(m_offsets.size() * sizeof(std::uint64_t)));
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+}
+
+auto OpeningBook::release() noexcept -> void {
+#ifndef _WIN32
+    if (m_mapped) {
+        ::munmap(const_cast<char *>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+}
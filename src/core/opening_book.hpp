@@ -0,0 +1,79 @@
+#ifndef OPENING_BOOK_HPP
+#define OPENING_BOOK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <libataxx/position.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Opening positions, one FEN per line
+// The file is mapped into memory rather than read, and only the offset of each line is kept,
+// so even very large books are quick to open and cheap to share between threads
+// Every line is parsed once when the book is opened, so bad FENs are caught before any games start
+// and games can start from a position without parsing anything
+class OpeningBook {
+   public:
+    // Without a file there's only the startpos
+    [[nodiscard]] OpeningBook();
+
+    // The line index can be saved next to the book and loaded next time, as long as the book hasn't changed
+    // Throws if any line isn't a valid FEN
+    [[nodiscard]] explicit OpeningBook(const std::string &path, const bool cache_index = false);
+
+    OpeningBook(const OpeningBook &) = delete;
+
+    OpeningBook &operator=(const OpeningBook &) = delete;
+
+    [[nodiscard]] OpeningBook(OpeningBook &&other) noexcept;
+
+    OpeningBook &operator=(OpeningBook &&other) noexcept;
+
+    ~OpeningBook();
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return m_offsets.size();
+    }
+
+    [[nodiscard]] auto operator[](const std::size_t idx) const noexcept -> std::string_view;
+
+    [[nodiscard]] auto position(const std::size_t idx) const noexcept -> const libataxx::Position & {
+        return m_positions[idx];
+    }
+
+    // Only the index is shuffled, the same seed always gives the same order
+    auto shuffle(const std::uint32_t seed) -> void;
+
+    // Keep only the first of each set of positions that are the same after rotating or reflecting the board, or
+    // swapping colours, since they'd all play out the same way
+    auto deduplicate() -> void;
+
+    // How many positions deduplicate() removed
+    [[nodiscard]] auto num_duplicates() const noexcept -> std::size_t {
+        return m_num_duplicates;
+    }
+
+   private:
+    auto build_index() -> void;
+
+    auto parse_positions() -> void;
+
+    // The index lives next to the book in a .idx file
+    [[nodiscard]] auto load_index(const std::string &book_path) -> bool;
+
+    auto save_index(const std::string &book_path) const -> void;
+
+    auto release() noexcept -> void;
+
+    const char *m_data = nullptr;
+    std::size_t m_size = 0;
+    bool m_mapped = false;
+    std::vector<char> m_contents;
+    std::vector<std::uint64_t> m_offsets;
+    // Kept in the same order as the offsets
+    std::vector<libataxx::Position> m_positions;
+    std::size_t m_num_duplicates = 0;
+};
+
+#endif
@@ -1,12 +1,19 @@
 #ifndef PARSE_OPENINGS_HPP
 #define PARSE_OPENINGS_HPP
 
+#include <cstdint>
 #include <string>
-#include <vector>
+#include "../opening_book.hpp"
 
 namespace parse {
 
-[[nodiscard]] std::vector<std::string> openings(const std::string &path, const bool shuffle);
+// The same seed gives the same order when shuffling
+// Duplicates are removed before shuffling, so the order doesn't depend on which ones were removed
+[[nodiscard]] OpeningBook openings(const std::string &path,
+                                   const bool shuffle,
+                                   const std::uint32_t seed,
+                                   const bool cache_index = false,
+                                   const bool unique = false);
 
 }  // namespace parse
 
@@ -0,0 +1,119 @@
+#include "pgn.hpp"
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include "../ataxx/parse_move.hpp"
+
+namespace parse {
+
+namespace {
+
+[[nodiscard]] auto is_result(const std::string_view str) -> bool {
+    return str == "1-0" || str == "0-1" || str == "1/2-1/2" || str == "*";
+}
+
+[[nodiscard]] auto parse_result(const std::string_view str) -> libataxx::Result {
+    if (str == "1-0") {
+        return libataxx::Result::BlackWin;
+    } else if (str == "0-1") {
+        return libataxx::Result::WhiteWin;
+    } else if (str == "1/2-1/2") {
+        return libataxx::Result::Draw;
+    } else {
+        return libataxx::Result::None;
+    }
+}
+
+[[nodiscard]] auto parse_reason(const std::string_view str) -> ResultReason {
+    // Reasons are only ever added to the end, after None
+    for (int i = 0; i <= static_cast<int>(ResultReason::Solved); ++i) {
+        const auto reason = static_cast<ResultReason>(i);
+        if (reason == ResultReason::None) {
+            continue;
+        }
+        if (adjudication_string(reason) == str) {
+            return reason;
+        }
+    }
+    throw std::invalid_argument("Unknown adjudication reason " + std::string(str));
+}
+
+}  // namespace
+
+auto pgn(std::istream &is, const PGNSettings &settings, const std::function<void(const PGNGame &)> &func) -> void {
+    PGNGame game;
+    std::string line;
+    auto in_comment = false;
+    auto expect_movetime = false;
+
+    const auto reset = [&]() {
+        game = PGNGame{};
+        in_comment = false;
+        expect_movetime = false;
+    };
+
+    while (std::getline(is, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        // Tag pair
+        if (!in_comment && !line.empty() && line[0] == '[') {
+            const auto space = line.find(' ');
+            const auto open = line.find('"');
+            const auto close = line.rfind('"');
+            if (space == std::string::npos || open == std::string::npos || close <= open) {
+                throw std::invalid_argument("Invalid tag " + line);
+            }
+
+            const auto name = line.substr(1, space - 1);
+            const auto value = line.substr(open + 1, close - open - 1);
+
+            if (name == settings.colour1) {
+                game.player1 = value;
+            } else if (name == settings.colour2) {
+                game.player2 = value;
+            } else if (name == "FEN") {
+                game.game.startpos = libataxx::Position(value);
+                game.game.endpos = game.game.startpos;
+            } else if (name == "Result") {
+                game.game.result = parse_result(value);
+            } else if (name == "Adjudicated") {
+                game.game.reason = parse_reason(value);
+            }
+            continue;
+        }
+
+        // Movetext
+        std::istringstream ss(line);
+        std::string word;
+        while (ss >> word) {
+            if (in_comment) {
+                if (word == "}") {
+                    in_comment = false;
+                } else if (word == "movetime") {
+                    expect_movetime = true;
+                } else if (expect_movetime && !game.game.history.empty()) {
+                    game.game.history.back().movetime = std::stoi(word);
+                    expect_movetime = false;
+                }
+            } else if (word == "{") {
+                in_comment = true;
+            } else if (is_result(word)) {
+                func(game);
+                reset();
+            } else if (word.back() == '.') {
+                continue;
+            } else {
+                const auto move = parse_move(word);
+                if (!game.game.endpos.is_legal_move(move)) {
+                    throw std::invalid_argument("Illegal move " + word + " in " + game.game.endpos.get_fen());
+                }
+                game.game.endpos.makemove(move);
+                game.game.history.push_back(MoveThingy{.move = move});
+            }
+        }
+    }
+}
+
+}  // namespace parse
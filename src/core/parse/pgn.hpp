@@ -0,0 +1,24 @@
+#ifndef PARSE_PGN_HPP
+#define PARSE_PGN_HPP
+
+#include <functional>
+#include <istream>
+#include <string>
+#include "../pgn.hpp"
+#include "../play.hpp"
+
+namespace parse {
+
+struct PGNGame {
+    std::string player1;
+    std::string player2;
+    GameThingy game;
+};
+
+// Read games in the format written by format_pgn(), calling the function once for each game
+// Movetimes are only known if the games were written with verbose enabled
+auto pgn(std::istream &is, const PGNSettings &settings, const std::function<void(const PGNGame &)> &func) -> void;
+
+}  // namespace parse
+
+#endif
@@ -1,6 +1,7 @@
 #include "settings.hpp"
 #include <filesystem>
 #include <fstream>
+#include <iostream>
 #include <nlohmann/json.hpp>
 #include <stdexcept>
 
@@ -45,10 +46,16 @@ namespace parse {
             settings.ratinginterval = b.get<int>();
         } else if (a == "concurrency") {
             settings.concurrency = b.get<int>();
+        } else if (a == "affinity") {
+            settings.affinity = b.get<bool>();
+        } else if (a == "max_engines") {
+            settings.max_engines = b.get<int>();
         } else if (a == "colour1") {
             settings.pgn.colour1 = b.get<std::string>();
         } else if (a == "colour2") {
             settings.pgn.colour2 = b.get<std::string>();
+        } else if (a == "recover") {
+            settings.recover = b.get<bool>();
         } else if (a == "debug") {
             settings.debug = b.get<bool>();
         } else if (a == "verbose") {
@@ -73,6 +80,8 @@ namespace parse {
                     settings.adjudication.easyfill = val.get<bool>();
                 } else if (key == "gamelength") {
                     settings.adjudication.gamelength = val.get<int>();
+                } else if (key == "solve") {
+                    settings.adjudication.solve = val.get<int>();
                 } else if (key == "timeout_buffer") {
                     settings.adjudication.timeout_buffer = val.get<int>();
                 }
@@ -85,6 +94,10 @@ namespace parse {
                     settings.repeat = val.get<bool>();
                 } else if (key == "shuffle") {
                     settings.shuffle = val.get<bool>();
+                } else if (key == "index") {
+                    settings.openings_index = val.get<bool>();
+                } else if (key == "unique") {
+                    settings.openings_unique = val.get<bool>();
                 }
             }
         } else if (a == "timecontrol") {
@@ -122,12 +135,46 @@ namespace parse {
                     settings.pgn.event = val.get<std::string>();
                 }
             }
+        } else if (a == "binary") {
+            for (const auto &[key, val] : b.items()) {
+                if (key == "enabled") {
+                    settings.binary.enabled = val.get<bool>();
+                } else if (key == "override") {
+                    settings.binary.override = val.get<bool>();
+                } else if (key == "path") {
+                    settings.binary.path = val.get<std::string>();
+                }
+            }
         } else if (a == "sprt") {
+            // Settings from before there was a choice of model keep meaning the same thing
+            if (b.value("enabled", false) && !b.contains("model")) {
+                std::cerr << "Warning: sprt:model not set, using trinomial with BayesElo bounds. Set it to pentanomial "
+                             "to score pairs of games together, with logistic Elo bounds\n";
+            }
+
             for (const auto &[key, val] : b.items()) {
                 if (key == "enabled") {
                     settings.sprt.enabled = val.get<bool>();
                 } else if (key == "autostop") {
                     settings.sprt.autostop = val.get<bool>();
+                } else if (key == "model") {
+                    const auto model = val.get<std::string>();
+                    if (model == "pentanomial") {
+                        settings.sprt.pentanomial = true;
+                    } else if (model == "trinomial") {
+                        settings.sprt.pentanomial = false;
+                    } else {
+                        throw std::runtime_error("Unknown SPRT model " + model);
+                    }
+                } else if (key == "stop") {
+                    const auto stop = val.get<std::string>();
+                    if (stop == "finish") {
+                        settings.sprt.abort = false;
+                    } else if (stop == "abort") {
+                        settings.sprt.abort = true;
+                    } else {
+                        throw std::runtime_error("Unknown SPRT stop " + stop);
+                    }
                 } else if (key == "confidence") {
                     settings.sprt.alpha = 1.0f - val.get<float>();
                     settings.sprt.beta = 1.0f - val.get<float>();
@@ -141,6 +188,65 @@ namespace parse {
                     settings.sprt.elo1 = val.get<float>();
                 }
             }
+        } else if (a == "eventloop") {
+            for (const auto &[key, val] : b.items()) {
+                if (key == "enabled") {
+                    settings.eventloop.enabled = val.get<bool>();
+                } else if (key == "threads") {
+                    settings.eventloop.threads = val.get<int>();
+                }
+            }
+        } else if (a == "resources") {
+            for (const auto &[key, val] : b.items()) {
+                if (key == "enabled") {
+                    settings.resources.enabled = val.get<bool>();
+                } else if (key == "cores") {
+                    settings.resources.cores = val.get<int>();
+                } else if (key == "memory") {
+                    settings.resources.memory = val.get<int>();
+                }
+            }
+        } else if (a == "stats") {
+            for (const auto &[key, val] : b.items()) {
+                if (key == "enabled") {
+                    settings.stats.enabled = val.get<bool>();
+                } else if (key == "path") {
+                    settings.stats.path = val.get<std::string>();
+                } else if (key == "interval") {
+                    settings.stats.interval = val.get<int>();
+                }
+            }
+        } else if (a == "distributed") {
+            for (const auto &[key, val] : b.items()) {
+                if (key == "mode") {
+                    const auto mode = val.get<std::string>();
+                    if (mode == "off") {
+                        settings.distributed.mode = DistributedSettings::Mode::Off;
+                    } else if (mode == "coordinator") {
+                        settings.distributed.mode = DistributedSettings::Mode::Coordinator;
+                    } else if (mode == "node") {
+                        settings.distributed.mode = DistributedSettings::Mode::Node;
+                    } else {
+                        throw std::runtime_error("Unknown distributed mode " + mode);
+                    }
+                } else if (key == "host") {
+                    settings.distributed.host = val.get<std::string>();
+                } else if (key == "port") {
+                    settings.distributed.port = val.get<int>();
+                } else if (key == "batch") {
+                    settings.distributed.batch = val.get<int>();
+                } else if (key == "lease_timeout") {
+                    settings.distributed.lease_timeout = val.get<int>();
+                }
+            }
+        } else if (a == "checkpoint") {
+            for (const auto &[key, val] : b.items()) {
+                if (key == "enabled") {
+                    settings.checkpoint.enabled = val.get<bool>();
+                } else if (key == "path") {
+                    settings.checkpoint.path = val.get<std::string>();
+                }
+            }
         } else if (a == "options") {
             for (const auto &[key, val] : b.items()) {
                 engine_options.emplace_back(key, val);
@@ -173,6 +279,19 @@ namespace parse {
                 details.builtin = b.get<std::string>();
             } else if (a == "arguments") {
                 details.arguments = b.get<std::string>();
+            } else if (a == "isready") {
+                details.isready = b.get<bool>();
+            } else if (a == "ponder") {
+                details.ponder = b.get<bool>();
+            } else if (a == "position") {
+                const auto mode = b.get<std::string>();
+                if (mode == "moves") {
+                    details.send_moves = true;
+                } else if (mode == "fen") {
+                    details.send_moves = false;
+                } else {
+                    throw std::runtime_error("Unrecognised engine position mode: '" + mode + "'");
+                }
             } else if (a == "options") {
                 for (const auto &[key, val] : b.items()) {
                     const auto iter =
@@ -237,6 +356,20 @@ namespace parse {
         if (engine.proto == EngineProtocol::Unknown) {
             throw std::runtime_error("Unrecognised engine protocol");
         }
+
+        // KataGo needs several round trips to get a move, so can't be waited on by the event loop
+        if (settings.eventloop.enabled && engine.proto == EngineProtocol::KataGo) {
+            throw std::runtime_error("KataGo engines can't be used with the event loop");
+        }
+
+        if (engine.ponder && engine.proto != EngineProtocol::UAI && engine.proto != EngineProtocol::FSF) {
+            throw std::runtime_error("Only UAI and FSF engines can ponder");
+        }
+
+        // Pondering engines need to be listened to while their opponent thinks, which the event loop doesn't do
+        if (settings.eventloop.enabled && engine.ponder) {
+            throw std::runtime_error("Pondering engines can't be used with the event loop");
+        }
     }
 
     // Sanity checks
@@ -244,7 +377,26 @@ namespace parse {
         throw std::invalid_argument("Must be at least 2 engines");
     } else if (settings.concurrency < 1) {
         throw std::invalid_argument("Must be at least 1 thread");
+    } else if (settings.eventloop.enabled && settings.eventloop.threads < 1) {
+        throw std::invalid_argument("Must be at least 1 event loop thread");
+    } else if (settings.resources.cores < 0 || settings.resources.memory < 0) {
+        throw std::invalid_argument("Resource limits can't be negative");
+    } else if (settings.stats.enabled && settings.stats.interval < 0) {
+        throw std::invalid_argument("Stats interval can't be negative");
+    } else if (settings.distributed.mode != DistributedSettings::Mode::Off &&
+               (settings.distributed.port < 0 || settings.distributed.port > 65535)) {
+        throw std::invalid_argument("Invalid distributed port");
+    } else if (settings.distributed.batch < 1) {
+        throw std::invalid_argument("Must lease at least 1 game at a time");
+    } else if (settings.distributed.lease_timeout < 1) {
+        throw std::invalid_argument("Lease timeout must be positive");
+    }
+
+#ifndef __linux__
+    if (settings.affinity) {
+        throw std::invalid_argument("CPU affinity is only supported on Linux");
     }
+#endif
 
     return settings;
 }
@@ -1,6 +1,8 @@
 #include "pgn.hpp"
+#include <charconv>
 #include <ctime>
-#include <fstream>
+#include <iterator>
+#include <string_view>
 
 [[nodiscard]] auto result_string(const libataxx::Result result) -> std::string {
     switch (result) {
@@ -29,6 +31,8 @@
             return "Max game length reached";
         case ResultReason::IllegalMove:
             return "Illegal move";
+        case ResultReason::Solved:
+            return "Solved";
         default:
             return "*";
     }
@@ -41,65 +45,84 @@
     return timeString;
 }
 
-auto write_as_pgn(const PGNSettings &settings,
-                  const std::string &player1,
-                  const std::string &player2,
-                  const GameThingy &data) -> void {
-    std::ofstream f(settings.path, std::fstream::out | std::fstream::app);
-    if (!f.is_open()) {
-        return;
-    }
+// Append without going through a stream
+auto append_int(std::string &out, const long long n) -> void {
+    char buffer[24];
+    const auto [end, ec] = std::to_chars(std::begin(buffer), std::end(buffer), n);
+    out.append(buffer, end);
+}
+
+auto append_tag(std::string &out, const std::string_view name, const std::string_view value) -> void {
+    out += '[';
+    out += name;
+    out += " \"";
+    out += value;
+    out += "\"]\n";
+}
 
+auto format_pgn(std::string &out,
+                const PGNSettings &settings,
+                const std::string &player1,
+                const std::string &player2,
+                const GameThingy &data) -> void {
     const auto material_difference = data.endpos.get_black().count() - data.endpos.get_white().count();
 
-    f << "[Event \"" << settings.event << "\"]\n";
-    f << "[Site \"CuteAtaxx\"]\n";
-    f << "[Date \"" << current_time_string() << "\"]\n";
-    f << "[Round \"1\"]\n";
-    f << "[" << settings.colour1 << " \"" << player1 << "\"]\n";
-    f << "[" << settings.colour2 << " \"" << player2 << "\"]\n";
-    f << "[Result \"" << result_string(data.result) << "\"]\n";
-    f << "[FEN \"" << data.startpos.get_fen() << "\"]\n";
-    f << "[FinalFEN \"" << data.endpos.get_fen() << "\"]\n";
+    append_tag(out, "Event", settings.event);
+    append_tag(out, "Site", "CuteAtaxx");
+    append_tag(out, "Date", current_time_string());
+    append_tag(out, "Round", "1");
+    append_tag(out, settings.colour1, player1);
+    append_tag(out, settings.colour2, player2);
+    append_tag(out, "Result", result_string(data.result));
+    append_tag(out, "FEN", data.startpos.get_fen());
+    append_tag(out, "FinalFEN", data.endpos.get_fen());
     if (data.reason != ResultReason::None) {
-        f << "[Adjudicated \"" << adjudication_string(data.reason) << "\"]\n";
+        append_tag(out, "Adjudicated", adjudication_string(data.reason));
     }
     if (data.result == libataxx::Result::BlackWin) {
-        f << "[Winner \"" << player1 << "\"]\n";
-        f << "[Loser \"" << player2 << "\"]\n";
+        append_tag(out, "Winner", player1);
+        append_tag(out, "Loser", player2);
     } else if (data.result == libataxx::Result::WhiteWin) {
-        f << "[Winner \"" << player2 << "\"]\n";
-        f << "[Loser \"" << player1 << "\"]\n";
+        append_tag(out, "Winner", player2);
+        append_tag(out, "Loser", player1);
     }
-    f << "[PlyCount \"" << data.history.size() << "\"]\n";
-    f << "[Material \"" << (material_difference >= 0 ? "+" : "") << material_difference << "\"]\n";
-    f << "\n";
+    out += "[PlyCount \"";
+    append_int(out, data.history.size());
+    out += "\"]\n";
+    out += "[Material \"";
+    out += material_difference >= 0 ? "+" : "";
+    append_int(out, material_difference);
+    out += "\"]\n";
+    out += "\n";
 
     const auto white_first = data.startpos.get_turn() == libataxx::Side::White;
     auto ply = 0;
 
     if (white_first) {
-        f << "1... ";
+        out += "1... ";
         ply++;
     }
 
     for (const auto &info : data.history) {
         if (ply % 2 == 0) {
-            f << ply / 2 + 1 << ". ";
+            append_int(out, ply / 2 + 1);
+            out += ". ";
         }
 
-        f << info.move << " ";
+        out += static_cast<std::string>(info.move);
+        out += ' ';
 
         if (settings.verbose) {
-            f << "{";
-            f << " movetime " << info.movetime;
-            f << " } ";
+            out += "{ movetime ";
+            append_int(out, info.movetime);
+            out += " } ";
         }
 
         ply++;
     }
 
-    f << result_string(data.result) << "\n";
+    out += result_string(data.result);
+    out += "\n";
 
-    f << "\n\n";
+    out += "\n\n";
 }
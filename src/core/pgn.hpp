@@ -14,9 +14,15 @@ struct PGNSettings {
     bool override = false;
 };
 
-auto write_as_pgn(const PGNSettings &settings,
-                  const std::string &player1,
-                  const std::string &player2,
-                  const GameThingy &data) -> void;
+[[nodiscard]] auto result_string(const libataxx::Result result) -> std::string;
+
+[[nodiscard]] auto adjudication_string(const ResultReason reason) -> std::string;
+
+// Append the game to the end of the string
+auto format_pgn(std::string &out,
+                const PGNSettings &settings,
+                const std::string &player1,
+                const std::string &player2,
+                const GameThingy &data) -> void;
 
 #endif
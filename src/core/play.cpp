@@ -1,35 +1,78 @@
 #include "play.hpp"
-#include <cassert>
+#include <array>
 #include <chrono>
-#include <iostream>
 #include <memory>
-#include "ataxx/adjudicate.hpp"
+#include <optional>
 #include "ataxx/parse_move.hpp"
+#include "engine/builtin/builtin.hpp"
 #include "engine/engine.hpp"
-#include "play.hpp"
+#include "game_state.hpp"
+
+namespace {
+
+// How long a pondering engine has to give up its search once told to stop
+// The time isn't charged to either clock
+constexpr auto stop_timeout = std::chrono::milliseconds(1000);
+
+// Let the engine that just moved think on its opponent's time, about the reply it expects
+// Returns the move it's pondering on, if it gave one worth pondering on
+[[nodiscard]] auto start_pondering(const GameState &state, Engine &engine, const libataxx::Side side)
+    -> std::optional<libataxx::Move> {
+    const auto &guess = engine.ponder_move();
+    if (!guess) {
+        return std::nullopt;
+    }
+
+    libataxx::Move move;
+    try {
+        move = parse_move(*guess);
+    } catch (...) {
+        return std::nullopt;
+    }
 
-[[nodiscard]] constexpr auto make_win_for(const libataxx::Side s) noexcept {
-    return s == libataxx::Side::Black ? libataxx::Result::BlackWin : libataxx::Result::WhiteWin;
+    if (!state.position().is_legal_move(move)) {
+        return std::nullopt;
+    }
+
+    auto pos = state.position();
+    pos.makemove(move);
+    if (pos.is_gameover()) {
+        return std::nullopt;
+    }
+
+    auto moves = state.moves();
+    moves.push_back(move);
+
+    engine.position(state.startpos(), moves, pos);
+    engine.ponder(state.search_settings(side));
+
+    return move;
 }
 
-static_assert(make_win_for(libataxx::Side::Black) == libataxx::Result::BlackWin);
-static_assert(make_win_for(libataxx::Side::White) == libataxx::Result::WhiteWin);
+auto stop_pondering(Engine &engine) -> void {
+    engine.set_deadline(std::chrono::steady_clock::now() + stop_timeout);
+    engine.stop_pondering();
+    engine.set_deadline(std::nullopt);
+}
+
+}  // namespace
 
 [[nodiscard]] GameThingy play(const AdjudicationSettings &adjudication,
                               const GameSettings &game,
                               std::shared_ptr<Engine> engine1,
-                              std::shared_ptr<Engine> engine2) {
-    assert(!game.fen.empty());
-    assert(game.engine1.id != game.engine2.id);
+                              std::shared_ptr<Engine> engine2,
+                              const std::atomic<bool> *abort) {
+    GameState state(adjudication, game);
+
+    // Builtin engines can give us their moves directly
+    auto *const builtin1 = dynamic_cast<BuiltinEngine *>(engine1.get());
+    auto *const builtin2 = dynamic_cast<BuiltinEngine *>(engine2.get());
 
-    GameThingy info;
+    // The move each engine is pondering on, if it is
+    std::array<std::optional<libataxx::Move>, 2> pondering;
 
-    // Get engine & position settings
-    auto pos = libataxx::Position{game.fen};
-    int ply_count = 0;
-    info.startpos = pos;
-    auto tc1 = game.engine1.tc;
-    auto tc2 = game.engine2.tc;
+    engine1->set_interrupt(abort);
+    engine2->set_interrupt(abort);
 
     try {
         engine1->newgame();
@@ -39,126 +82,100 @@ static_assert(make_win_for(libataxx::Side::White) == libataxx::Result::WhiteWin)
         engine2->isready();
 
         // Play
-        while (!pos.is_gameover()) {
-            // Try to adjudicate based on material imbalance
-            if (adjudication.material && can_adjudicate_material(pos, *adjudication.material)) {
-                info.result = make_win_for(pos.get_turn());
-                info.reason = ResultReason::MaterialImbalance;
+        while (!state.check_finished()) {
+            if (abort && abort->load(std::memory_order_relaxed)) {
+                state.abort();
                 break;
             }
 
-            // Try to adjudicate based on "easy fill"
-            // This is when one side has to pass and the other can fill the rest of the board trivially to win
-            if (adjudication.easyfill && can_adjudicate_easyfill(pos)) {
-                info.result = make_win_for(!pos.get_turn());
-                info.reason = ResultReason::EasyFill;
-                break;
+            const auto side = state.turn();
+            auto &engine = side == libataxx::Side::Black ? engine1 : engine2;
+            const auto &engine_settings = side == libataxx::Side::Black ? game.engine1 : game.engine2;
+            auto &ponder_move = pondering[side == libataxx::Side::Black ? 0 : 1];
+
+            if (auto *const builtin = side == libataxx::Side::Black ? builtin1 : builtin2) {
+                const auto t0 = std::chrono::steady_clock::now();
+                const auto move = builtin->search(state.position(), state.search_settings());
+                const auto t1 = std::chrono::steady_clock::now();
+                const auto movetime = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+                state.apply(move, movetime, movetime);
+                continue;
             }
 
-            // Try to adjudicate based on game length
-            if (adjudication.gamelength && can_adjudicate_gamelength(pos, *adjudication.gamelength)) {
-                info.result = libataxx::Result::Draw;
-                info.reason = ResultReason::Gamelength;
-                break;
+            // Don't wait on the engine longer than it has to move
+            const auto time_limit = state.time_limit();
+
+            // An engine that guessed the opponent's move carries on with the search it already started
+            const auto is_ponderhit = ponder_move && *ponder_move == state.moves().back();
+            if (ponder_move && !is_ponderhit) {
+                stop_pondering(*engine);
             }
+            ponder_move.reset();
 
-            auto &engine = pos.get_turn() == libataxx::Side::Black ? engine1 : engine2;
-            auto &tc_us = pos.get_turn() == libataxx::Side::Black ? tc1 : tc2;
+            if (!is_ponderhit) {
+                if (time_limit) {
+                    engine->set_deadline(std::chrono::steady_clock::now() + *time_limit);
+                }
 
-            engine->position(pos);
+                engine->position(state.startpos(), state.moves(), state.position());
 
-            engine->isready();
+                if (engine_settings.isready) {
+                    engine->isready();
+                }
+            }
 
             // Start move timer
-            const auto t0 = std::chrono::high_resolution_clock::now();
+            const auto t0 = std::chrono::steady_clock::now();
+
+            // The engine's time starts now, time spent pondering is free
+            if (time_limit) {
+                engine->set_deadline(t0 + *time_limit);
+            }
 
             // Get move
-            const auto movestr = engine->go(tc_us);
+            const auto movestr = is_ponderhit ? engine->ponderhit() : engine->go(state.search_settings());
 
             // Stop move timer
-            const auto t1 = std::chrono::high_resolution_clock::now();
-
-            // Get move time
-            const auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0);
-
-            libataxx::Move move;
-
-            try {
-                // Parse move string
-                move = parse_move(movestr);
+            const auto t1 = std::chrono::steady_clock::now();
 
-                // Illegal move
-                if (!pos.is_legal_move(move)) {
-                    throw std::logic_error("Illegal move");
-                }
-            } catch (...) {
-                info.result = make_win_for(!pos.get_turn());
-                info.reason = ResultReason::IllegalMove;
-                std::cout << "Illegal move \"" << movestr << "\" played by "
-                          << (pos.get_turn() == libataxx::Side::Black ? game.engine1.name : game.engine2.name)
-                          << "\n\n";
-                break;
-            }
+            engine->set_deadline(std::nullopt);
 
-            ply_count++;
+            // Engines that don't talk to us through a pipe reply all at once
+            const auto first_reply = engine->first_reply_time().value_or(t1);
 
-            // Add move to .pgn
-            info.history.emplace_back(move, diff.count());
+            state.apply(movestr,
+                        std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0),
+                        std::chrono::duration_cast<std::chrono::microseconds>(first_reply - t0));
 
-            // Update clocks
-            if (tc_us.type == SearchSettings::Type::Time) {
-                if (pos.get_turn() == libataxx::Side::Black) {
-                    tc1.btime -= diff.count();
-                    tc2.btime -= diff.count();
-                } else {
-                    tc1.wtime -= diff.count();
-                    tc2.wtime -= diff.count();
+            // It's the opponent's turn now, so any problems are left for the engine's next move rather than
+            // being blamed on the opponent
+            if (engine_settings.ponder && !state.check_finished()) {
+                try {
+                    ponder_move = start_pondering(state, *engine, side);
+                } catch (...) {
+                    ponder_move.reset();
                 }
             }
-
-            // Out of time?
-            if (tc_us.type == SearchSettings::Type::Movetime) {
-                if (diff.count() > tc_us.movetime + adjudication.timeout_buffer) {
-                    info.result = make_win_for(!pos.get_turn());
-                    info.reason = ResultReason::OutOfTime;
-                    break;
-                }
-            } else if (tc_us.type == SearchSettings::Type::Time) {
-                if (tc_us.btime <= 0) {
-                    info.result = libataxx::Result::WhiteWin;
-                    info.reason = ResultReason::OutOfTime;
-                    break;
-                } else if (tc_us.wtime <= 0) {
-                    info.result = libataxx::Result::BlackWin;
-                    info.reason = ResultReason::OutOfTime;
-                    break;
-                }
-            }
-
-            // Increments
-            if (tc_us.type == SearchSettings::Type::Time) {
-                if (pos.get_turn() == libataxx::Side::Black) {
-                    tc1.btime += tc_us.binc;
-                    tc2.btime += tc_us.binc;
-                } else {
-                    tc1.wtime += tc_us.winc;
-                    tc2.wtime += tc_us.winc;
-                }
-            }
-
-            pos.makemove(move);
         }
+    } catch (const EngineTimeout &) {
+        state.timeout();
     } catch (...) {
-        info.reason = ResultReason::EngineCrash;
-        info.result = make_win_for(!pos.get_turn());
+        state.crash();
     }
 
-    // Game finished normally
-    if (info.result == libataxx::Result::None) {
-        info.result = pos.get_result();
+    // Engines can't be used for another game until they've stopped pondering
+    // Those that don't stop are marked as broken and won't be reused
+    for (std::size_t i = 0; i < pondering.size(); ++i) {
+        if (pondering[i]) {
+            try {
+                stop_pondering(i == 0 ? *engine1 : *engine2);
+            } catch (...) {
+            }
+        }
     }
 
-    info.endpos = pos;
+    engine1->set_interrupt(nullptr);
+    engine2->set_interrupt(nullptr);
 
-    return info;
+    return state.finish();
 }
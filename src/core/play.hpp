@@ -1,6 +1,8 @@
 #ifndef PLAY_HPP
 #define PLAY_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <libataxx/move.hpp>
 #include <libataxx/position.hpp>
 #include <memory>
@@ -18,15 +20,20 @@ enum class ResultReason : int
     IllegalMove,
     EngineCrash,
     None,
+    // The match stopped before the game could finish, these games are never saved
+    Aborted,
+    // Few enough empty squares were left to work out the result
+    Solved,
 };
 
 class SearchSettings;
 class Engine;
 
+// Refers to the opening and engine settings rather than copying them, so they must outlive the game
 struct GameSettings {
-    std::string fen;
-    EngineSettings engine1;
-    EngineSettings engine2;
+    const libataxx::Position &startpos;
+    const EngineSettings &engine1;
+    const EngineSettings &engine2;
 };
 
 struct AdjudicationSettings {
@@ -34,11 +41,16 @@ struct AdjudicationSettings {
     std::optional<int> material;
     std::optional<bool> easyfill;
     int timeout_buffer = 0;
+    // The number of empty squares at which to start solving positions
+    std::optional<int> solve;
 };
 
 struct MoveThingy {
     libataxx::Move move = libataxx::Move::nomove();
     int movetime = 0;
+    // Time from sending the go command to the engine's first reply, and to its move
+    std::int64_t first_reply_us = 0;
+    std::int64_t total_us = 0;
 };
 
 struct GameThingy {
@@ -49,9 +61,11 @@ struct GameThingy {
     libataxx::Position endpos;
 };
 
+// The game is abandoned within a move of abort being set, with the engine to move told to stop searching
 [[nodiscard]] GameThingy play(const AdjudicationSettings &adjudication,
                               const GameSettings &game,
                               std::shared_ptr<Engine> engine1,
-                              std::shared_ptr<Engine> engine2);
+                              std::shared_ptr<Engine> engine2,
+                              const std::atomic<bool> *abort = nullptr);
 
 #endif
@@ -0,0 +1,29 @@
+#ifndef TOURNAMENT_CREATE_HPP
+#define TOURNAMENT_CREATE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include "gauntlet.hpp"
+#include "generator.hpp"
+#include "roundrobin.hpp"
+#include "roundrobin_mixed.hpp"
+#include "types.hpp"
+
+[[nodiscard]] inline auto make_generator(const TournamentType type,
+                                         const std::size_t players,
+                                         const std::size_t games,
+                                         const std::size_t openings) -> std::shared_ptr<TournamentGenerator> {
+    switch (type) {
+        case TournamentType::RoundRobin:
+            return std::make_shared<RoundRobinGenerator>(players, games, openings, true);
+        case TournamentType::Gauntlet:
+            return std::make_shared<GauntletGenerator>(players, games, openings, true);
+        case TournamentType::RoundRobinMixed:
+            return std::make_shared<RoundRobinMixedGenerator>(players, games, openings, true);
+        default:
+            throw std::runtime_error("Unknown tournament type");
+    }
+}
+
+#endif
@@ -17,55 +17,34 @@ class [[nodiscard]] GauntletGenerator final : public TournamentGenerator {
         return idx >= expected();
     }
 
-    [[nodiscard]] virtual auto expected() -> std::size_t override {
+    [[nodiscard]] virtual auto expected() const -> std::size_t override {
         return num_games * (num_players - 1);
     }
 
     [[nodiscard]] virtual auto next() -> GameInfo override {
-        GameInfo result;
+        return game_at(idx++);
+    }
+
+    [[nodiscard]] virtual auto game_at(const std::size_t n) const -> GameInfo override {
+        const auto match_game = n % num_games;
+        const auto player2 = 1 + (n / num_games) % (num_players - 1);
+        const auto opening = repeat ? (match_game / 2) % num_openings : match_game % num_openings;
 
         const auto is_mirror = match_game % 2 == 1;
         if (is_mirror && repeat) {
-            result = GameInfo{idx, opening, player2, 0};
+            return GameInfo{n, opening, player2, 0};
         } else {
-            result = GameInfo{idx, opening, 0, player2};
+            return GameInfo{n, opening, 0, player2};
         }
-
-        increment();
-
-        return result;
     }
 
    private:
-    virtual auto increment() -> void override {
-        idx++;
-        match_game++;
-
-        if (match_game >= num_games) {
-            match_game = 0;
-            player2++;
-        }
-
-        if (player2 >= num_players) {
-            player2 = 1;
-        }
-
-        if (repeat) {
-            opening = (match_game / 2) % num_openings;
-        } else {
-            opening = match_game % num_openings;
-        }
-    }
-
     std::size_t num_players = 0;
     std::size_t num_games = 0;
     std::size_t num_openings = 0;
     bool repeat = true;
     // state
     std::size_t idx = 0;
-    std::size_t opening = 0;
-    std::size_t player2 = 1;
-    std::size_t match_game = 0;
 };
 
 #endif
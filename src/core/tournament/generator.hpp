@@ -22,12 +22,13 @@ class TournamentGenerator {
 
     [[nodiscard]] virtual auto is_finished() -> bool = 0;
 
-    [[nodiscard]] virtual auto expected() -> std::size_t = 0;
+    [[nodiscard]] virtual auto expected() const -> std::size_t = 0;
 
     [[nodiscard]] virtual auto next() -> GameInfo = 0;
 
-   private:
-    virtual auto increment() -> void = 0;
+    // The game at a given index, without changing any state
+    // Safe to call from multiple threads, so games can be claimed with nothing more than an atomic counter
+    [[nodiscard]] virtual auto game_at(const std::size_t idx) const -> GameInfo = 0;
 };
 
 #endif
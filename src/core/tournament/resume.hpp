@@ -0,0 +1,58 @@
+#ifndef TOURNAMENT_RESUME_HPP
+#define TOURNAMENT_RESUME_HPP
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <vector>
+#include "generator.hpp"
+
+// The games from another generator that haven't been finished yet, keeping their original ids
+// Gaps left by games that were in progress come first, then everything after the last finished game
+class [[nodiscard]] ResumeGenerator final : public TournamentGenerator {
+   public:
+    ResumeGenerator(std::shared_ptr<const TournamentGenerator> generator,
+                    const std::size_t finished_below,
+                    const std::set<std::size_t> &finished)
+        : m_generator(generator),
+          m_tail(finished.empty() ? finished_below : *finished.rbegin() + 1) {
+        for (auto n = finished_below; n < m_tail; ++n) {
+            if (!finished.contains(n)) {
+                m_gaps.push_back(n);
+            }
+        }
+    }
+
+    virtual ~ResumeGenerator() {
+    }
+
+    [[nodiscard]] virtual auto is_finished() -> bool override {
+        return idx >= expected();
+    }
+
+    [[nodiscard]] virtual auto expected() const -> std::size_t override {
+        const auto total = m_generator->expected();
+        return m_gaps.size() + (total > m_tail ? total - m_tail : 0);
+    }
+
+    [[nodiscard]] virtual auto next() -> GameInfo override {
+        return game_at(idx++);
+    }
+
+    [[nodiscard]] virtual auto game_at(const std::size_t n) const -> GameInfo override {
+        if (n < m_gaps.size()) {
+            return m_generator->game_at(m_gaps[n]);
+        } else {
+            return m_generator->game_at(m_tail + n - m_gaps.size());
+        }
+    }
+
+   private:
+    std::shared_ptr<const TournamentGenerator> m_generator;
+    std::vector<std::size_t> m_gaps;
+    std::size_t m_tail = 0;
+    // state
+    std::size_t idx = 0;
+};
+
+#endif
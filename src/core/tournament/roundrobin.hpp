@@ -18,66 +18,47 @@ class [[nodiscard]] RoundRobinGenerator final : public TournamentGenerator {
         return idx >= expected();
     }
 
-    [[nodiscard]] virtual auto expected() -> std::size_t override {
+    [[nodiscard]] virtual auto expected() const -> std::size_t override {
         const auto games_per_player = num_games * (num_players - 1);
         return games_per_player * num_players / 2;
     }
 
     [[nodiscard]] virtual auto next() -> GameInfo override {
-        GameInfo result;
-
-        const auto is_mirror = match_game % 2 == 1;
-        if (is_mirror && repeat) {
-            result = GameInfo{idx, opening, player2, player1};
-        } else {
-            result = GameInfo{idx, opening, player1, player2};
-        }
-
-        increment();
-
-        return result;
+        return game_at(idx++);
     }
 
-   private:
-    virtual auto increment() -> void override {
-        idx++;
-        match_game++;
-
-        if (match_game >= num_games) {
-            match_game = 0;
-            player2++;
-        }
+    [[nodiscard]] virtual auto game_at(const std::size_t n) const -> GameInfo override {
+        const auto match_game = n % num_games;
+        const auto opening = repeat ? (match_game / 2) % num_openings : match_game % num_openings;
 
-        if (player2 >= num_players) {
+        // Pairings are played in order (0, 1), (0, 2) ... (1, 2), (1, 3) ...
+        const auto num_pairings = num_players * (num_players - 1) / 2;
+        auto pairing = (n / num_games) % num_pairings;
+        std::size_t player1 = 0;
+        while (pairing >= num_players - player1 - 1) {
+            pairing -= num_players - player1 - 1;
             player1++;
-            player2 = player1 + 1;
         }
+        const auto player2 = player1 + 1 + pairing;
 
-        if (player1 >= num_players - 1) {
-            player1 = 0;
-            player2 = 1;
-        }
+        assert(player1 < num_players);
+        assert(player2 < num_players);
 
-        if (repeat) {
-            opening = (match_game / 2) % num_openings;
+        const auto is_mirror = match_game % 2 == 1;
+        if (is_mirror && repeat) {
+            return GameInfo{n, opening, player2, player1};
         } else {
-            opening = match_game % num_openings;
+            return GameInfo{n, opening, player1, player2};
         }
-
-        assert(player1 < num_players);
-        assert(player2 < num_players);
     }
 
+   private:
     std::size_t num_players = 0;
     std::size_t num_games = 0;
     std::size_t num_openings = 0;
     bool repeat = true;
     // state
     std::size_t idx = 0;
-    std::size_t opening = 0;
-    std::size_t player1 = 0;
-    std::size_t player2 = 1;
-    std::size_t match_game = 0;
 };
 
 #endif
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <utility>
 #include <vector>
 #include "generator.hpp"
 
@@ -14,15 +15,44 @@ class [[nodiscard]] RoundRobinMixedGenerator final : public TournamentGenerator
                              const std::size_t openings,
                              const bool r)
         : num_players(players), num_games(games), num_openings(openings), repeat(r) {
+        std::vector<std::size_t> magic;
         magic.emplace_back(0);
         for (std::size_t i = 2; i < players + (players % 2); ++i) {
             magic.emplace_back(i);
         }
         magic.emplace_back(1);
 
-        player1 = 0;
-        player2 = 1;
-        opening = num_openings - 1;
+        // The pairings repeat once every player has met every other player,
+        // so we only need to store a single cycle of them
+        std::size_t player1 = 0;
+        std::size_t player2 = 1;
+        while (pairings.size() < players * (players - 1) / 2) {
+            player1++;
+            player2--;
+
+            auto okay = true;
+            do {
+                okay = true;
+
+                // New round?
+                if (player1 >= player2) {
+                    std::rotate(magic.rbegin(), magic.rbegin() + 1, magic.rend() - 1);
+                    player1 = 0;
+                    player2 = magic.size() - 1;
+                    okay = false;
+                }
+
+                // Bye?
+                const auto is_bye = magic.at(player1) == num_players || magic.at(player2) == num_players;
+                if (is_bye) {
+                    player1++;
+                    player2--;
+                    okay = false;
+                }
+            } while (!okay);
+
+            pairings.emplace_back(magic.at(player1), magic.at(player2));
+        }
     }
 
     virtual ~RoundRobinMixedGenerator() {
@@ -32,69 +62,34 @@ class [[nodiscard]] RoundRobinMixedGenerator final : public TournamentGenerator
         return idx >= expected();
     }
 
-    [[nodiscard]] virtual auto expected() -> std::size_t override {
+    [[nodiscard]] virtual auto expected() const -> std::size_t override {
         const auto games_per_player = num_games * (num_players - 1);
         return games_per_player * num_players / 2;
     }
 
     [[nodiscard]] virtual auto next() -> GameInfo override {
-        increment();
-        const auto is_mirror = repeat && idx % 2 == 0;
-        if (is_mirror) {
-            return GameInfo{idx - 1, opening, magic.at(player2), magic.at(player1)};
-        } else {
-            return GameInfo{idx - 1, opening, magic.at(player1), magic.at(player2)};
-        }
+        return game_at(idx++);
     }
 
-   private:
-    virtual auto increment() -> void override {
-        if (repeat) {
-            if (idx % 2 == 0) {
-                player1++;
-                player2--;
-                opening++;
-            }
+    [[nodiscard]] virtual auto game_at(const std::size_t n) const -> GameInfo override {
+        assert(!pairings.empty());
+        const auto pairing = repeat ? n / 2 : n;
+        const auto opening = pairing % num_openings;
+        const auto [player1, player2] = pairings[pairing % pairings.size()];
+        const auto is_mirror = repeat && n % 2 == 1;
+        if (is_mirror) {
+            return GameInfo{n, opening, player2, player1};
         } else {
-            player1++;
-            player2--;
-            opening++;
+            return GameInfo{n, opening, player1, player2};
         }
-
-        auto okay = true;
-        do {
-            okay = true;
-
-            // New round?
-            if (player1 >= player2) {
-                std::rotate(magic.rbegin(), magic.rbegin() + 1, magic.rend() - 1);
-                player1 = 0;
-                player2 = magic.size() - 1;
-                okay = false;
-            }
-
-            // Bye?
-            const auto is_bye = magic.at(player1) == num_players || magic.at(player2) == num_players;
-            if (is_bye) {
-                player1++;
-                player2--;
-                okay = false;
-            }
-        } while (!okay);
-
-        opening = opening % num_openings;
-
-        idx++;
     }
 
+   private:
     std::size_t num_players = 0;
     std::size_t num_games = 0;
     std::size_t num_openings = 0;
     std::size_t idx = 0;
-    std::size_t opening = 0;
-    std::size_t player1 = 0;
-    std::size_t player2 = 1;
-    std::vector<std::size_t> magic;
+    std::vector<std::pair<std::size_t, std::size_t>> pairings;
     bool repeat = true;
 };
 
@@ -53,3 +53,29 @@ TEST_CASE("Adjudicate - easyfill false") {
         REQUIRE(!can_adjudicate_easyfill(pos));
     }
 }
+
+TEST_CASE("Adjudicate - settings") {
+    // White has to pass and black can fill the rest of the board
+    const auto easyfill = libataxx::Position("oxx4/xxx4/xxx4/7/7/7/7 o 0 1");
+    // Black is to move and far ahead on material
+    const auto material = libataxx::Position("xxxxxxx/xxxxxxx/7/7/7/7/6o x 0 1");
+
+    const auto all = AdjudicationSettings{300, 10, true, 0, {}};
+    REQUIRE(adjudicate(easyfill, all)->result == libataxx::Result::BlackWin);
+    REQUIRE(adjudicate(easyfill, all)->reason == ResultReason::EasyFill);
+    REQUIRE(adjudicate(material, all)->result == libataxx::Result::BlackWin);
+    REQUIRE(adjudicate(material, all)->reason == ResultReason::MaterialImbalance);
+    REQUIRE(!adjudicate(libataxx::Position("startpos"), all));
+
+    const auto none = AdjudicationSettings{};
+    REQUIRE(!adjudicate(easyfill, none));
+    REQUIRE(!adjudicate(material, none));
+
+    const auto easyfill_off = AdjudicationSettings{{}, {}, false, 0, {}};
+    REQUIRE(!adjudicate(easyfill, easyfill_off));
+
+    // Game length is only a draw if nothing else applies
+    const auto short_game = AdjudicationSettings{1, 10, true, 0, {}};
+    REQUIRE(adjudicate(material, short_game)->reason == ResultReason::MaterialImbalance);
+    REQUIRE(adjudicate(libataxx::Position("startpos"), short_game)->result == libataxx::Result::Draw);
+}
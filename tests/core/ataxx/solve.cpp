@@ -0,0 +1,73 @@
+#include "core/ataxx/solve.hpp"
+#include <doctest/doctest.h>
+#include <libataxx/position.hpp>
+#include "core/ataxx/adjudicate.hpp"
+
+TEST_CASE("Solve - results") {
+    // Black has to pass and white fills the last square
+    REQUIRE(solve(libataxx::Position("xxxxxxx/xxxxxxx/xxxxxxx/ooooooo/ooooooo/ooooooo/oooooo1 x 0 1"), 1000) ==
+            libataxx::Result::WhiteWin);
+
+    // Black is behind, but filling the last square captures enough to win
+    REQUIRE(solve(libataxx::Position("xxxxxxx/xxxxxxx/xxxxxxx/ooooooo/ooooooo/ooooooo/ooooox1 x 0 1"), 1000) ==
+            libataxx::Result::BlackWin);
+
+    // Already over
+    REQUIRE(solve(libataxx::Position("xxxxxxx/xxxxxxx/xxxxxxx/xxxxxxx/ooooooo/ooooooo/ooooooo x 0 1"), 1000) ==
+            libataxx::Result::BlackWin);
+}
+
+TEST_CASE("Solve - node limit") {
+    REQUIRE(!solve(libataxx::Position("startpos"), 100));
+}
+
+TEST_CASE("Solve - ply limit") {
+    // Black has to pass before white can fill the last square
+    const auto pos = libataxx::Position("xxxxxxx/xxxxxxx/xxxxxxx/ooooooo/ooooooo/ooooooo/oooooo1 x 0 1");
+    REQUIRE(solve(pos, 1000, 2) == libataxx::Result::WhiteWin);
+    REQUIRE(!solve(pos, 1000, 1));
+}
+
+TEST_CASE("Solve - adjudication") {
+    const auto pos = libataxx::Position("xxxxxxx/xxxxxxx/xxxxxxx/ooooooo/ooooooo/ooooooo/ooooox1 x 0 1");
+
+    REQUIRE(!adjudicate(pos, AdjudicationSettings{}));
+
+    auto settings = AdjudicationSettings{};
+    settings.solve = 1;
+    const auto adjudication = adjudicate(pos, settings);
+    REQUIRE(adjudication);
+    REQUIRE(adjudication->result == libataxx::Result::BlackWin);
+    REQUIRE(adjudication->reason == ResultReason::Solved);
+
+    // Too many empty squares to try
+    REQUIRE(!adjudicate(libataxx::Position("startpos"), settings));
+
+    // Game length comes first, and the result has to be decided before the game gets there
+    settings.gamelength = 1;
+    REQUIRE(adjudicate(pos, settings)->reason == ResultReason::Gamelength);
+    settings.gamelength = 2;
+    REQUIRE(adjudicate(pos, settings)->reason == ResultReason::Solved);
+
+    // White has to pass before black can fill the last square, one move too late
+    const auto pass = libataxx::Position("ooooooo/ooooooo/ooooooo/xxxxxxx/xxxxxxx/xxxxxxx/xxxxxx1 o 0 1");
+    REQUIRE(!adjudicate(pass, settings));
+    settings.gamelength = 3;
+    REQUIRE(adjudicate(pass, settings)->result == libataxx::Result::BlackWin);
+}
+
+TEST_CASE("Solve - retries") {
+    auto settings = AdjudicationSettings{};
+    settings.solve = 49;
+    auto state = AdjudicationState{};
+
+    REQUIRE(!adjudicate(libataxx::Position("startpos"), settings, state));
+    REQUIRE(state.unsolved_empties == 45);
+
+    // Not tried again until a square is filled
+    const auto pos = libataxx::Position("xxxxxxx/xxxxxxx/xxxxxxx/ooooooo/ooooooo/ooooooo/ooooox1 x 0 1");
+    state.unsolved_empties = 1;
+    REQUIRE(!adjudicate(pos, settings, state));
+    state.unsolved_empties = 2;
+    REQUIRE(adjudicate(pos, settings, state)->reason == ResultReason::Solved);
+}
@@ -0,0 +1,28 @@
+#include "core/ataxx/symmetry.hpp"
+#include <doctest/doctest.h>
+#include <libataxx/position.hpp>
+#include <string>
+
+[[nodiscard]] auto hash(const std::string &fen) -> std::uint64_t {
+    return canonical_hash(libataxx::Position(fen));
+}
+
+TEST_CASE("Symmetry - same") {
+    const auto fen = "x5o/7/7/7/7/7/ox4x x 0 1";
+    // Mirrored files, mirrored ranks, transposed, colours swapped
+    REQUIRE(hash(fen) == hash("o5x/7/7/7/7/7/x4xo x 0 1"));
+    REQUIRE(hash(fen) == hash("ox4x/7/7/7/7/7/x5o x 0 1"));
+    REQUIRE(hash(fen) == hash("x5o/7/7/7/7/x6/o5x x 0 1"));
+    REQUIRE(hash(fen) == hash("o5x/7/7/7/7/7/xo4o o 0 1"));
+    // The move counters don't matter
+    REQUIRE(hash(fen) == hash("x5o/7/7/7/7/7/ox4x x 12 30"));
+}
+
+TEST_CASE("Symmetry - different") {
+    const auto fen = "x5o/7/7/7/7/7/ox4x x 0 1";
+    REQUIRE(hash(fen) != hash("x5o/7/7/7/7/7/ox4x o 0 1"));
+    REQUIRE(hash(fen) != hash("x5o/7/7/7/7/7/o4xx x 0 1"));
+    REQUIRE(hash(fen) != hash("x5o/7/7/7/7/7/o5x x 0 1"));
+    REQUIRE(hash("x5o/7/3-3/7/7/7/o5x x 0 1") != hash("x5o/7/7/3-3/7/7/o5x x 0 1"));
+    REQUIRE(hash("x5o/7/3-3/7/7/7/o5x x 0 1") != hash("x5o/7/7/7/7/7/o5x x 0 1"));
+}
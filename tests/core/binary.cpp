@@ -0,0 +1,100 @@
+#include "core/binary.hpp"
+#include <doctest/doctest.h>
+#include <array>
+#include <sstream>
+#include <string>
+#include "core/engine/create.hpp"
+#include "core/engine/settings.hpp"
+#include "core/parse/pgn.hpp"
+#include "core/pgn.hpp"
+#include "core/play.hpp"
+
+[[nodiscard]] auto play_game(const std::string &fen) -> GameThingy {
+    const auto settings1 =
+        EngineSettings{0, EngineProtocol::Unknown, "Test1", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+    const auto settings2 =
+        EngineSettings{1, EngineProtocol::Unknown, "Test2", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+    const auto adjudication = AdjudicationSettings{{}, {}, {}, 0, {}};
+    const auto startpos = libataxx::Position(fen);
+    const auto game = GameSettings{startpos, settings1, settings2};
+    auto result = play(adjudication, game, make_engine(settings1, {}, {}), make_engine(settings2, {}, {}));
+
+    // Give every move a movetime to check
+    for (std::size_t i = 0; i < result.history.size(); ++i) {
+        result.history[i].movetime = static_cast<int>(i * 37);
+    }
+
+    return result;
+}
+
+auto check_same(const GameThingy &a, const GameThingy &b) -> void {
+    REQUIRE(a.result == b.result);
+    REQUIRE(a.reason == b.reason);
+    REQUIRE(a.startpos.get_fen() == b.startpos.get_fen());
+    REQUIRE(a.endpos.get_fen() == b.endpos.get_fen());
+    REQUIRE(a.history.size() == b.history.size());
+    for (std::size_t i = 0; i < a.history.size(); ++i) {
+        REQUIRE(a.history[i].move == b.history[i].move);
+        REQUIRE(a.history[i].movetime == b.history[i].movetime);
+    }
+}
+
+TEST_CASE("Binary - roundtrip") {
+    const auto games = std::array<GameThingy, 3>{
+        play_game("startpos"),
+        play_game("x5o/7/2-1-2/7/2-1-2/7/o5x o 0 1"),
+        play_game("x-1-1-o/-1-1-1-/1-1-1-1/-1-1-1-/1-1-1-1/-1-1-1-/o-1-1-x x 0 1"),
+    };
+
+    std::string buffer = binary_header();
+    format_binary_engine(buffer, 0, "Test1");
+    format_binary_engine(buffer, 1, "Test2");
+    for (std::size_t i = 0; i < games.size(); ++i) {
+        format_binary_game(buffer, i % 2, 1 - i % 2, games[i]);
+    }
+
+    std::istringstream ss(buffer);
+    auto reader = BinaryReader(ss);
+    auto game = BinaryGame{};
+
+    for (std::size_t i = 0; i < games.size(); ++i) {
+        REQUIRE(reader.next(game));
+        REQUIRE(game.engine1 == i % 2);
+        REQUIRE(game.engine2 == 1 - i % 2);
+        REQUIRE(reader.engine_name(game.engine1) == (i % 2 ? "Test2" : "Test1"));
+        check_same(game.game, games[i]);
+    }
+
+    REQUIRE(!reader.next(game));
+}
+
+TEST_CASE("Binary - bad header") {
+    std::istringstream ss("PGN");
+    REQUIRE_THROWS(BinaryReader(ss));
+}
+
+TEST_CASE("PGN - roundtrip") {
+    auto settings = PGNSettings{};
+    settings.verbose = true;
+
+    const auto games = std::array<GameThingy, 2>{
+        play_game("startpos"),
+        play_game("x5o/7/2-1-2/7/2-1-2/7/o5x o 0 1"),
+    };
+
+    std::string buffer;
+    for (const auto &game : games) {
+        format_pgn(buffer, settings, "Test1", "Test2", game);
+    }
+
+    std::istringstream ss(buffer);
+    std::size_t idx = 0;
+    parse::pgn(ss, settings, [&](const parse::PGNGame &game) {
+        REQUIRE(idx < games.size());
+        REQUIRE(game.player1 == "Test1");
+        REQUIRE(game.player2 == "Test2");
+        check_same(game.game, games[idx]);
+        idx++;
+    });
+    REQUIRE(idx == games.size());
+}
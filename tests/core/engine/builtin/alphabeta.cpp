@@ -0,0 +1,52 @@
+#include "core/engine/builtin/alphabeta.hpp"
+#include <chrono>
+#include <doctest/doctest.h>
+#include <libataxx/position.hpp>
+#include "core/engine/create.hpp"
+#include "core/engine/settings.hpp"
+#include "core/play.hpp"
+
+TEST_CASE("Alpha-beta builtin - takes the win") {
+    auto engine = AlphaBetaBuiltin();
+
+    // Moving to b2 or c2 captures every white piece
+    const auto pos = libataxx::Position("7/7/7/7/1oo4/7/x6 x 0 1");
+    for (const auto depth : {1, 2, 4}) {
+        auto after = pos;
+        after.makemove(engine.search(pos, SearchSettings::as_depth(depth)));
+        REQUIRE(after.get_result() == libataxx::Result::BlackWin);
+    }
+}
+
+TEST_CASE("Alpha-beta builtin - search limits") {
+    auto engine = AlphaBetaBuiltin();
+    const auto pos = libataxx::Position("startpos");
+
+    REQUIRE(pos.is_legal_move(engine.search(pos, SearchSettings::as_depth(3))));
+    REQUIRE(pos.is_legal_move(engine.search(pos, SearchSettings::as_nodes(1))));
+    REQUIRE(pos.is_legal_move(engine.search(pos, SearchSettings::as_nodes(5000))));
+
+    const auto t0 = std::chrono::steady_clock::now();
+    REQUIRE(pos.is_legal_move(engine.search(pos, SearchSettings::as_movetime(50))));
+    REQUIRE(pos.is_legal_move(engine.search(pos, SearchSettings::as_time(1000, 1000, 0, 0))));
+    const auto elapsed = std::chrono::steady_clock::now() - t0;
+    REQUIRE(elapsed < std::chrono::milliseconds(500));
+
+    REQUIRE(engine.search(libataxx::Position("x6/7/7/7/7/7/7 o 0 1"), SearchSettings::as_depth(3)) ==
+            libataxx::Move::nullmove());
+}
+
+TEST_CASE("Alpha-beta builtin - beats mostcaptures") {
+    const auto settings1 =
+        EngineSettings{0, EngineProtocol::Unknown, "AlphaBeta", "alphabeta", "", "", SearchSettings::as_depth(3), {}};
+    const auto settings2 =
+        EngineSettings{1, EngineProtocol::Unknown, "Most", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+
+    const auto engine1 = make_engine(settings1, {}, {});
+    const auto engine2 = make_engine(settings2, {}, {});
+    const auto adjudication = AdjudicationSettings{{}, {}, {}, 0, {}};
+    const auto startpos = libataxx::Position("startpos");
+    const auto game = GameSettings{startpos, settings1, settings2};
+
+    REQUIRE(play(adjudication, game, engine1, engine2).result == libataxx::Result::BlackWin);
+}
@@ -0,0 +1,78 @@
+#include "core/engine/pool.hpp"
+#include <doctest/doctest.h>
+#include <memory>
+
+[[nodiscard]] auto make_pool_settings(const int id) -> EngineSettings {
+    return EngineSettings{id, EngineProtocol::Unknown, "Most", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+}
+
+TEST_CASE("Engine pool - reuse") {
+    auto pool = EnginePool(4);
+
+    auto engine = pool.create(make_pool_settings(0));
+    REQUIRE(engine);
+    REQUIRE(!pool.try_acquire(0));
+
+    // Only handed back out for the same engine settings
+    const auto *const original = engine.get();
+    pool.release(0, std::move(engine));
+    REQUIRE(!pool.try_acquire(1));
+    engine = pool.try_acquire(0);
+    REQUIRE(engine.get() == original);
+
+    // Taken, so not idle any more
+    REQUIRE(!pool.try_acquire(0));
+
+    REQUIRE(pool.stats().created == 1);
+    REQUIRE(pool.stats().reused == 1);
+}
+
+TEST_CASE("Engine pool - evict the oldest idle engine") {
+    auto pool = EnginePool(2);
+
+    auto engine1 = pool.create(make_pool_settings(0));
+    auto engine2 = pool.create(make_pool_settings(1));
+    const std::weak_ptr<Engine> watch1 = engine1;
+    const auto *const original2 = engine2.get();
+    pool.release(0, std::move(engine1));
+    pool.release(1, std::move(engine2));
+
+    // At the limit, so the engine idle for longest is shut down to make room
+    auto engine3 = pool.create(make_pool_settings(2));
+    REQUIRE(engine3);
+    REQUIRE(watch1.expired());
+    REQUIRE(!pool.try_acquire(0));
+    REQUIRE(pool.try_acquire(1).get() == original2);
+
+    // Nothing idle to evict, so we go over the limit rather than not play
+    auto engine4 = pool.create(make_pool_settings(3));
+    auto engine5 = pool.create(make_pool_settings(4));
+    REQUIRE(engine4);
+    REQUIRE(engine5);
+
+    REQUIRE(pool.stats().created == 5);
+    REQUIRE(pool.stats().reused == 1);
+}
+
+TEST_CASE("Engine pool - discard") {
+    auto pool = EnginePool(2);
+
+    auto engine1 = pool.create(make_pool_settings(0));
+    auto engine2 = pool.create(make_pool_settings(1));
+    const std::weak_ptr<Engine> watch2 = engine2;
+    const auto *const original1 = engine1.get();
+
+    // An engine in a bad state isn't handed out again
+    pool.discard(std::move(engine2));
+    REQUIRE(watch2.expired());
+    REQUIRE(!pool.try_acquire(1));
+
+    // Which makes room for a new engine without evicting the idle one
+    pool.release(0, std::move(engine1));
+    auto engine3 = pool.create(make_pool_settings(1));
+    REQUIRE(engine3);
+    REQUIRE(pool.try_acquire(0).get() == original1);
+
+    REQUIRE(pool.stats().created == 3);
+    REQUIRE(pool.stats().reused == 1);
+}
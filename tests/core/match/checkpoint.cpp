@@ -0,0 +1,101 @@
+#include "core/match/checkpoint.hpp"
+#include <doctest/doctest.h>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+#include "core/match/settings.hpp"
+#include "core/opening_book.hpp"
+#include "core/play.hpp"
+
+[[nodiscard]] auto write_book(const std::string &name, const std::vector<std::string> &fens) -> std::string {
+    const auto path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream f(path, std::ios::binary);
+    for (const auto &fen : fens) {
+        f << fen << "\n";
+    }
+    return path;
+}
+
+TEST_CASE("Checkpoint - save and load") {
+    const auto path = (std::filesystem::temp_directory_path() / "cuteataxx_test_checkpoint.json").string();
+    const auto openings = OpeningBook();
+
+    auto checkpoint = Checkpoint{};
+    checkpoint.seed = 1234;
+    check_checkpoint(checkpoint, {"Engine1", "Engine2"}, TournamentType::Gauntlet, openings, 6);
+
+    auto game = GameThingy{};
+    game.startpos = libataxx::Position("x5o/7/7/7/7/7/o5x x 0 1");
+    game.endpos = game.startpos;
+    game.result = libataxx::Result::BlackWin;
+    game.reason = ResultReason::EngineCrash;
+    game.history.push_back(MoveThingy{libataxx::Move(libataxx::Square(5)), 3, 1500, 3000});
+
+    checkpoint.add(GameInfo{0, 0, 0, 1}, game);
+    checkpoint.add(GameInfo{1, 0, 1, 0}, game);
+    checkpoint.add(GameInfo{4, 0, 0, 1}, game);
+
+    save_checkpoint(path, checkpoint, Settings{});
+    const auto loaded = load_checkpoint(path);
+    std::filesystem::remove(path);
+
+    REQUIRE(loaded);
+    REQUIRE(loaded->seed == 1234);
+    REQUIRE(loaded->num_games == 6);
+    REQUIRE(loaded->engines == checkpoint.engines);
+    REQUIRE(loaded->tournament == TournamentType::Gauntlet);
+    REQUIRE(loaded->openings_hash == checkpoint.openings_hash);
+    REQUIRE(loaded->finished_below == 2);
+    REQUIRE(loaded->finished == std::set<std::size_t>{4});
+    REQUIRE(loaded->num_finished() == 3);
+    REQUIRE(loaded->half_pairs == checkpoint.half_pairs);
+    REQUIRE(loaded->results.games_played == 3);
+    REQUIRE(loaded->results.black_wins == 3);
+    REQUIRE(loaded->results.pentanomial == checkpoint.results.pentanomial);
+    REQUIRE(loaded->results.scores.at("Engine1").wins == 2);
+    REQUIRE(loaded->results.scores.at("Engine1").crashes == 1);
+    REQUIRE(loaded->results.scores.at("Engine2").crashes == 2);
+    REQUIRE(loaded->results.latencies.at("Engine1").move.counts ==
+            checkpoint.results.latencies.at("Engine1").move.counts);
+
+    // No file means nothing to resume
+    REQUIRE(!load_checkpoint(path));
+}
+
+TEST_CASE("Checkpoint - different match") {
+    const auto black = std::string("x5o/7/7/7/7/7/o5x x 0 1");
+    const auto white = std::string("x5o/7/7/7/7/7/o5x o 0 1");
+    const auto path1 = write_book("cuteataxx_test_checkpoint1.txt", {black, white});
+    const auto path2 = write_book("cuteataxx_test_checkpoint2.txt", {white, black});
+    const auto openings1 = OpeningBook(path1);
+    const auto openings2 = OpeningBook(path2);
+    const auto engines = std::vector<std::string>{"Engine1", "Engine2"};
+
+    auto checkpoint = Checkpoint{};
+    check_checkpoint(checkpoint, engines, TournamentType::RoundRobin, openings1, 8);
+
+    // The same match carries on
+    auto same = checkpoint;
+    check_checkpoint(same, engines, TournamentType::RoundRobin, openings1, 8);
+
+    auto copy = checkpoint;
+    REQUIRE_THROWS(check_checkpoint(copy, {"Engine2", "Engine1"}, TournamentType::RoundRobin, openings1, 8));
+    REQUIRE_THROWS(check_checkpoint(copy, engines, TournamentType::RoundRobin, openings1, 10));
+    REQUIRE_THROWS(check_checkpoint(copy, engines, TournamentType::Gauntlet, openings1, 8));
+
+    // Same openings in a different order, as if they'd been shuffled
+    REQUIRE_THROWS(check_checkpoint(copy, engines, TournamentType::RoundRobin, openings2, 8));
+
+    // Older checkpoints don't know which openings they were for
+    copy.tournament.reset();
+    copy.openings_hash.reset();
+    check_checkpoint(copy, engines, TournamentType::Gauntlet, openings2, 8);
+    REQUIRE(copy.tournament == TournamentType::Gauntlet);
+    REQUIRE(copy.openings_hash);
+    REQUIRE(copy.openings_hash != checkpoint.openings_hash);
+
+    std::filesystem::remove(path1);
+    std::filesystem::remove(path2);
+}
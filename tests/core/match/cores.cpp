@@ -0,0 +1,93 @@
+#include "core/match/cores.hpp"
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include "core/match/settings.hpp"
+
+[[nodiscard]] auto make_engine_settings(const int id, const std::string &threads, const bool ponder) -> EngineSettings {
+    auto engine = EngineSettings{};
+    engine.id = id;
+    engine.name = "Engine" + std::to_string(id);
+    engine.options = {{"Hash", "16"}, {"Threads", threads}};
+    engine.ponder = ponder;
+    return engine;
+}
+
+TEST_CASE("Cores per game") {
+    auto settings = Settings{};
+    settings.engines.push_back(make_engine_settings(0, "1", false));
+    settings.engines.push_back(make_engine_settings(1, "1", false));
+
+    // Engines take turns
+    REQUIRE(cores_per_game(settings) == 1);
+
+    // Both engines can search at once
+    settings.engines[1].ponder = true;
+    REQUIRE(cores_per_game(settings) == 2);
+
+    // The worst pairing decides
+    settings.engines.push_back(make_engine_settings(2, "4", false));
+    REQUIRE(cores_per_game(settings) == 5);
+
+    settings.engines[1].ponder = false;
+    REQUIRE(cores_per_game(settings) == 4);
+
+    // Nonsense thread counts count as one
+    settings.engines[2].options = {{"threads", "many"}};
+    REQUIRE(cores_per_game(settings) == 1);
+}
+
+TEST_CASE("Max concurrency") {
+    auto settings = Settings{};
+    settings.engines.push_back(make_engine_settings(0, "1", true));
+    settings.engines.push_back(make_engine_settings(1, "1", true));
+
+    REQUIRE(available_cores() >= 1);
+    REQUIRE(max_concurrency(settings) == std::max(1, available_cores() / 2));
+}
+
+TEST_CASE("Parse cpulist") {
+    REQUIRE(parse_cpulist("") == std::vector<int>{});
+    REQUIRE(parse_cpulist("3") == std::vector<int>{3});
+    REQUIRE(parse_cpulist("0-3") == std::vector<int>{0, 1, 2, 3});
+    REQUIRE(parse_cpulist("0-1,8-9,12") == std::vector<int>{0, 1, 8, 9, 12});
+}
+
+TEST_CASE("Layout cores") {
+    const auto nodes = std::vector<std::vector<int>>{{0, 1, 2, 3, 4}, {5, 6, 7, 8, 9}};
+
+    // Slots don't cross nodes while there's room for them on one
+    REQUIRE(layout_cores(nodes, 4, 2) == std::vector<std::vector<int>>{{0, 1}, {2, 3}, {5, 6}, {7, 8}});
+
+    // Then the spare cores on each node are used
+    REQUIRE(layout_cores(nodes, 5, 2) == std::vector<std::vector<int>>{{0, 1}, {2, 3}, {5, 6}, {7, 8}, {4, 9}});
+
+    // Too many slots share with the first ones
+    REQUIRE(layout_cores(nodes, 4, 4) ==
+            std::vector<std::vector<int>>{{0, 1, 2, 3}, {5, 6, 7, 8}, {0, 1, 2, 3}, {5, 6, 7, 8}});
+
+    // Slots bigger than the machine get all of it
+    const auto all = std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    REQUIRE(layout_cores(nodes, 2, 16) == std::vector<std::vector<int>>{all, all});
+
+    REQUIRE(layout_cores({}, 2, 1).empty());
+}
+
+TEST_CASE("Split cores") {
+    auto engine1 = make_engine_settings(0, "2", false);
+    auto engine2 = make_engine_settings(1, "1", false);
+    const auto cores = std::vector<int>{4, 5, 6};
+
+    // Taking turns
+    REQUIRE(split_cores(cores, engine1, engine2) == std::pair{cores, cores});
+
+    // Searching at the same time
+    engine2.ponder = true;
+    REQUIRE(split_cores(cores, engine1, engine2) == std::pair{std::vector<int>{4, 5}, std::vector<int>{6}});
+
+    // Not enough cores to keep them apart
+    engine2.options = {{"Threads", "2"}};
+    REQUIRE(split_cores(cores, engine1, engine2) == std::pair{cores, cores});
+}
@@ -0,0 +1,213 @@
+#include <doctest/doctest.h>
+#include <chrono>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/match/checkpoint.hpp"
+#include "core/match/connection.hpp"
+#include "core/match/coordinator.hpp"
+#include "core/match/node.hpp"
+#include "core/match/protocol.hpp"
+#include "core/match/settings.hpp"
+#include "core/opening_book.hpp"
+
+#ifndef _WIN32
+
+[[nodiscard]] auto make_distributed_settings(const int num_games) -> Settings {
+    auto settings = Settings{};
+    settings.num_games = num_games;
+    settings.concurrency = 2;
+    settings.engines.push_back(
+        EngineSettings{0, EngineProtocol::Unknown, "Most", "mostcaptures", "", "", SearchSettings::as_depth(1), {}});
+    settings.engines.push_back(
+        EngineSettings{1, EngineProtocol::Unknown, "Least", "leastcaptures", "", "", SearchSettings::as_depth(1), {}});
+    settings.distributed.mode = DistributedSettings::Mode::Coordinator;
+    settings.distributed.port = 0;
+    // Don't leave games behind in the working directory
+    settings.pgn.enabled = false;
+    return settings;
+}
+
+[[nodiscard]] auto wait_for(Connection &connection) -> nlohmann::json {
+    while (true) {
+        if (const auto message = connection.next_message()) {
+            return *message;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (!connection.receive()) {
+            return {};
+        }
+    }
+}
+
+TEST_CASE("Distributed - game json") {
+    auto game = GameThingy{};
+    game.startpos = libataxx::Position("x5o/7/7/7/7/7/o5x x 0 1");
+    game.result = libataxx::Result::WhiteWin;
+    game.reason = ResultReason::OutOfTime;
+    game.history.push_back(MoveThingy{libataxx::Move(libataxx::Square(5)), 12, 345, 12345});
+
+    const auto copy = game_from_json(game_to_json(game));
+    REQUIRE(copy.startpos.get_fen() == game.startpos.get_fen());
+    REQUIRE(copy.result == game.result);
+    REQUIRE(copy.reason == game.reason);
+    REQUIRE(copy.history.size() == 1);
+    REQUIRE(copy.history[0].move == game.history[0].move);
+    REQUIRE(copy.history[0].movetime == 12);
+    REQUIRE(copy.history[0].first_reply_us == 345);
+    REQUIRE(copy.history[0].total_us == 12345);
+
+    auto bad = game_to_json(game);
+    bad["moves"].push_back({"g7", 0, 0, 0});
+    REQUIRE_THROWS(game_from_json(bad));
+
+    bad = game_to_json(game);
+    bad["reason"] = 100;
+    REQUIRE_THROWS(game_from_json(bad));
+}
+
+TEST_CASE("Distributed - playing settings") {
+    const auto settings = make_distributed_settings(2);
+    const auto ours = playing_settings(settings);
+    REQUIRE(!playing_settings_mismatch(ours, ours));
+
+    // Only where the engines are differs between machines
+    auto other = settings;
+    other.engines[0].path = "/somewhere/else";
+    other.engines[0].arguments = "-v";
+    other.distributed.mode = DistributedSettings::Mode::Node;
+    REQUIRE(!playing_settings_mismatch(ours, playing_settings(other)));
+
+    other = settings;
+    other.engines[1].tc = SearchSettings::as_depth(2);
+    REQUIRE(playing_settings_mismatch(ours, playing_settings(other)) == "engine Least");
+
+    other = settings;
+    other.engines[0].options.emplace_back("hash", "64");
+    REQUIRE(playing_settings_mismatch(ours, playing_settings(other)) == "engine Most");
+
+    other = settings;
+    other.adjudication.gamelength = 300;
+    REQUIRE(playing_settings_mismatch(ours, playing_settings(other)) == "adjudication");
+
+    // Nodes that don't say
+    REQUIRE(playing_settings_mismatch(ours, nlohmann::json()) == "adjudication");
+}
+
+TEST_CASE("Distributed - nodes share the games") {
+    const auto settings = make_distributed_settings(20);
+    const auto openings = OpeningBook();
+    const auto callbacks = Callbacks{};
+
+    auto coordinator = Coordinator(settings, openings, Checkpoint{}, callbacks);
+
+    auto node_settings = settings;
+    node_settings.distributed.mode = DistributedSettings::Mode::Node;
+    node_settings.distributed.port = coordinator.port();
+
+    std::vector<Results> node_results(2);
+    std::vector<std::thread> nodes;
+    for (std::size_t i = 0; i < node_results.size(); ++i) {
+        nodes.emplace_back([&node_settings, &callbacks, &node_results, i] {
+            node_results[i] = run_node(node_settings, callbacks);
+        });
+    }
+
+    const auto results = coordinator.run();
+
+    for (auto &node : nodes) {
+        node.join();
+    }
+
+    REQUIRE(results.games_played == 20);
+    REQUIRE(results.black_wins + results.white_wins + results.draws == 20);
+    REQUIRE(results.scores.at("Most").played == 20);
+    REQUIRE(node_results[0].games_played + node_results[1].games_played == 20);
+}
+
+TEST_CASE("Distributed - games are taken back from quiet nodes") {
+    auto settings = make_distributed_settings(4);
+    settings.distributed.lease_timeout = 200;
+    const auto openings = OpeningBook();
+    const auto callbacks = Callbacks{};
+
+    auto coordinator = Coordinator(settings, openings, Checkpoint{}, callbacks);
+
+    // Takes every game, then never plays any of them
+    auto quiet = Connection::connect(settings.distributed.host, coordinator.port());
+    const auto hello =
+        nlohmann::json{{"type", "hello"}, {"engines", {"Most", "Least"}}, {"settings", playing_settings(settings)}};
+    REQUIRE(quiet.send(hello));
+
+    auto node_settings = settings;
+    node_settings.distributed.mode = DistributedSettings::Mode::Node;
+    node_settings.distributed.port = coordinator.port();
+
+    Results results;
+    std::thread runner([&coordinator, &results] {
+        results = coordinator.run();
+    });
+
+    REQUIRE(wait_for(quiet)["type"] == "welcome");
+    REQUIRE(quiet.send({{"type", "lease"}, {"seq", 0}, {"count", 4}}));
+    const auto reply = wait_for(quiet);
+    REQUIRE(reply["type"] == "games");
+    REQUIRE(reply["games"].size() == 4);
+
+    // Everything has been handed out, so the node has to wait for the quiet one's lease to run out
+    Results node_results;
+    std::thread node([&node_settings, &callbacks, &node_results] {
+        node_results = run_node(node_settings, callbacks);
+    });
+
+    runner.join();
+    node.join();
+
+    REQUIRE(results.games_played == 4);
+    REQUIRE(node_results.games_played == 4);
+}
+
+TEST_CASE("Distributed - nodes that leave give their games back") {
+    const auto settings = make_distributed_settings(2);
+    const auto openings = OpeningBook();
+    const auto callbacks = Callbacks{};
+
+    auto coordinator = Coordinator(settings, openings, Checkpoint{}, callbacks);
+
+    auto node_settings = settings;
+    node_settings.distributed.port = coordinator.port();
+    node_settings.engines.pop_back();
+
+    auto results = Results{};
+    std::thread runner([&coordinator, &results] {
+        results = coordinator.run();
+    });
+
+    // Turned away for having different engines
+    REQUIRE_THROWS(static_cast<void>(run_node(node_settings, callbacks)));
+
+    // Or a different time control
+    node_settings.engines = settings.engines;
+    node_settings.engines[0].tc = SearchSettings::as_movetime(10);
+    REQUIRE_THROWS(static_cast<void>(run_node(node_settings, callbacks)));
+
+    {
+        auto node = Connection::connect(settings.distributed.host, coordinator.port());
+        const auto hello =
+            nlohmann::json{{"type", "hello"}, {"engines", {"Most", "Least"}}, {"settings", playing_settings(settings)}};
+        REQUIRE(node.send(hello));
+        REQUIRE(wait_for(node)["type"] == "welcome");
+        REQUIRE(node.send({{"type", "lease"}, {"seq", 0}, {"count", 2}}));
+        REQUIRE(wait_for(node)["games"].size() == 2);
+    }
+
+    // Disconnecting gave the games back, so someone else can play them
+    node_settings.engines = settings.engines;
+    REQUIRE(run_node(node_settings, callbacks).games_played == 2);
+
+    runner.join();
+    REQUIRE(results.games_played == 2);
+}
+
+#endif
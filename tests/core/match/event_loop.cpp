@@ -0,0 +1,135 @@
+#include "core/match/event_loop.hpp"
+#include <doctest/doctest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "core/match/checkpoint.hpp"
+#include "core/match/run.hpp"
+#include "core/match/settings.hpp"
+#include "core/opening_book.hpp"
+
+#ifdef __linux__
+
+[[nodiscard]] auto make_event_loop_settings(const int num_games) -> Settings {
+    auto settings = Settings{};
+    settings.num_games = num_games;
+    settings.concurrency = 5;
+    settings.eventloop.enabled = true;
+    settings.eventloop.threads = 2;
+    // Don't leave games behind in the working directory
+    settings.pgn.enabled = false;
+    settings.engines.push_back(
+        EngineSettings{0, EngineProtocol::Unknown, "Most", "mostcaptures", "", "", SearchSettings::as_depth(1), {}});
+    settings.engines.push_back(
+        EngineSettings{1, EngineProtocol::Unknown, "Least", "leastcaptures", "", "", SearchSettings::as_depth(1), {}});
+    settings.engines.push_back(
+        EngineSettings{2, EngineProtocol::Unknown, "Alpha", "alphabeta", "", "", SearchSettings::as_depth(1), {}});
+    return settings;
+}
+
+[[nodiscard]] auto make_event_loop_openings() -> OpeningBook {
+    const auto path = (std::filesystem::temp_directory_path() / "cuteataxx_test_event_loop.txt").string();
+    {
+        std::ofstream f(path);
+        f << "x5o/7/7/7/7/7/o5x x 0 1\n";
+        f << "x5o/7/2-1-2/7/2-1-2/7/o5x x 0 1\n";
+        f << "x5o/7/3-3/2-1-2/3-3/7/o5x x 0 1\n";
+    }
+    auto openings = OpeningBook(path);
+    std::filesystem::remove(path);
+    return openings;
+}
+
+TEST_CASE("Event loop - every game played once") {
+    const auto checkpoint_path = (std::filesystem::temp_directory_path() / "cuteataxx_test_event_loop.json").string();
+    std::filesystem::remove(checkpoint_path);
+
+    auto settings = make_event_loop_settings(12);
+    settings.checkpoint.enabled = true;
+    settings.checkpoint.path = checkpoint_path;
+    const auto openings = make_event_loop_openings();
+
+    auto num_started = 0;
+    auto num_finished = 0;
+    auto callbacks = Callbacks{};
+    callbacks.on_game_started = [&num_started](const auto, const auto, const auto) {
+        num_started++;
+    };
+    callbacks.on_game_finished = [&num_finished](const auto, const auto, const auto) {
+        num_finished++;
+    };
+
+    const auto results = run(settings, openings, Checkpoint{}, callbacks);
+
+    // 3 engines, 12 games per pair
+    REQUIRE(results.games_played == 36);
+    REQUIRE(results.games_started == 36);
+    REQUIRE(num_started == 36);
+    REQUIRE(num_finished == 36);
+    REQUIRE(results.black_wins + results.white_wins + results.draws == 36);
+    for (const auto &[name, score] : results.scores) {
+        REQUIRE(score.played == 24);
+    }
+
+    // Every game was recorded, and none of them twice
+    const auto checkpoint = load_checkpoint(checkpoint_path);
+    std::filesystem::remove(checkpoint_path);
+    REQUIRE(checkpoint);
+    REQUIRE(checkpoint->finished_below == 36);
+    REQUIRE(checkpoint->finished.empty());
+    REQUIRE(checkpoint->results.games_played == 36);
+
+    // The builtin engines always play the same moves, so the results are the same as playing a game per thread
+    settings.eventloop.enabled = false;
+    settings.checkpoint.enabled = false;
+    const auto threaded = run(settings, openings, Checkpoint{}, Callbacks{});
+    REQUIRE(threaded.games_played == results.games_played);
+    REQUIRE(threaded.black_wins == results.black_wins);
+    REQUIRE(threaded.white_wins == results.white_wins);
+    REQUIRE(threaded.draws == results.draws);
+    for (const auto &[name, score] : results.scores) {
+        REQUIRE(threaded.scores.at(name).wins == score.wins);
+        REQUIRE(threaded.scores.at(name).draws == score.draws);
+        REQUIRE(threaded.scores.at(name).losses == score.losses);
+    }
+}
+
+TEST_CASE("Event loop - SPRT stops the match") {
+    for (const auto abort : {false, true}) {
+        const auto checkpoint_path =
+            (std::filesystem::temp_directory_path() / "cuteataxx_test_event_loop_sprt.json").string();
+        std::filesystem::remove(checkpoint_path);
+
+        auto settings = make_event_loop_settings(1000);
+        settings.engines.pop_back();
+        settings.sprt.enabled = true;
+        settings.sprt.autostop = true;
+        settings.sprt.pentanomial = true;
+        settings.sprt.elo0 = 0.0f;
+        settings.sprt.elo1 = 100.0f;
+        settings.sprt.abort = abort;
+        settings.checkpoint.enabled = true;
+        settings.checkpoint.path = checkpoint_path;
+        const auto openings = make_event_loop_openings();
+
+        const auto results = run(settings, openings, Checkpoint{}, Callbacks{});
+        REQUIRE(results.games_played > 0);
+        REQUIRE(results.games_played < 1000);
+        REQUIRE(results.games_started == results.games_played);
+
+        // Finishing leaves no pair half played
+        if (!abort) {
+            REQUIRE(results.games_played % 2 == 0);
+        }
+
+        // Only the games that were played are saved, anything abandoned is played again if the match is resumed
+        const auto checkpoint = load_checkpoint(checkpoint_path);
+        std::filesystem::remove(checkpoint_path);
+        REQUIRE(checkpoint);
+        REQUIRE(checkpoint->num_finished() == static_cast<std::size_t>(results.games_played));
+        REQUIRE(checkpoint->results.games_played == results.games_played);
+    }
+}
+
+#endif
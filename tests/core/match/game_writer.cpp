@@ -0,0 +1,48 @@
+#include "core/match/game_writer.hpp"
+#include <doctest/doctest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "core/match/checkpoint.hpp"
+#include "core/match/settings.hpp"
+
+TEST_CASE("Game writer - checkpoint can't be saved") {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto pgn_path = (dir / "cuteataxx_test_writer.pgn").string();
+    std::filesystem::remove(pgn_path);
+
+    auto settings = Settings{};
+    settings.pgn.enabled = true;
+    settings.pgn.path = pgn_path;
+    settings.checkpoint.enabled = true;
+    settings.checkpoint.path = (dir / "cuteataxx_missing_dir" / "checkpoint.json").string();
+
+    auto checkpoint = Checkpoint{};
+    checkpoint.engines = {"Engine1", "Engine2"};
+    checkpoint.num_games = 2;
+
+    auto game = GameThingy{};
+    game.startpos = libataxx::Position("x5o/7/7/7/7/7/o5x x 0 1");
+    game.endpos = game.startpos;
+    game.result = libataxx::Result::Draw;
+    game.reason = ResultReason::Gamelength;
+
+    // The checkpoint fails every time, but the games are still written
+    {
+        auto writer = GameWriter(settings, checkpoint.engines, checkpoint, 1024, 1);
+        writer.push(GameInfo{0, 0, 0, 1}, game);
+        writer.push(GameInfo{1, 0, 1, 0}, game);
+        writer.stop();
+    }
+
+    std::ifstream f(pgn_path);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    const auto pgn = ss.str();
+    REQUIRE(pgn.find("[Result") != std::string::npos);
+    REQUIRE(pgn.find("[Result", pgn.find("[Result") + 1) != std::string::npos);
+    REQUIRE(!std::filesystem::exists(settings.checkpoint.path));
+
+    std::filesystem::remove(pgn_path);
+}
@@ -0,0 +1,76 @@
+#include "core/match/lease.hpp"
+#include <doctest/doctest.h>
+#include <chrono>
+#include <vector>
+
+TEST_CASE("Lease table - in order") {
+    const auto now = LeaseTable::Clock::now();
+    auto leases = LeaseTable(5);
+
+    REQUIRE(leases.lease(0, 2, now) == std::vector<std::size_t>{0, 1});
+    REQUIRE(leases.lease(1, 2, now) == std::vector<std::size_t>{2, 3});
+    REQUIRE(leases.lease(0, 2, now) == std::vector<std::size_t>{4});
+    REQUIRE(leases.lease(1, 2, now).empty());
+    REQUIRE(leases.num_leased() == 5);
+    REQUIRE(!leases.has_available());
+
+    for (std::size_t i = 0; i < 5; ++i) {
+        REQUIRE(!leases.is_finished());
+        REQUIRE(leases.complete(i));
+    }
+    REQUIRE(leases.is_finished());
+    REQUIRE(leases.num_leased() == 0);
+    REQUIRE(!leases.next_expiry());
+}
+
+TEST_CASE("Lease table - released games come first") {
+    const auto now = LeaseTable::Clock::now();
+    auto leases = LeaseTable(6);
+
+    REQUIRE(leases.lease(0, 3, now) == std::vector<std::size_t>{0, 1, 2});
+    REQUIRE(leases.complete(1));
+    REQUIRE(leases.release(0) == 2);
+    REQUIRE(leases.num_leased() == 0);
+    REQUIRE(leases.has_available());
+
+    REQUIRE(leases.lease(1, 3, now) == std::vector<std::size_t>{0, 2, 3});
+}
+
+TEST_CASE("Lease table - expiry") {
+    const auto now = LeaseTable::Clock::now();
+    const auto later = now + std::chrono::seconds(10);
+    auto leases = LeaseTable(4);
+
+    REQUIRE(leases.lease(0, 2, now) == std::vector<std::size_t>{0, 1});
+    REQUIRE(leases.lease(1, 2, later) == std::vector<std::size_t>{2, 3});
+    REQUIRE(leases.next_expiry() == now);
+
+    // Only the first node's lease has run out
+    REQUIRE(leases.expire(now) == 2);
+    REQUIRE(leases.next_expiry() == later);
+
+    // Renewing keeps hold of the games
+    leases.renew(1, later + std::chrono::seconds(10));
+    REQUIRE(leases.expire(later) == 0);
+
+    REQUIRE(leases.lease(2, 4, later) == std::vector<std::size_t>{0, 1});
+}
+
+TEST_CASE("Lease table - first result counts") {
+    const auto now = LeaseTable::Clock::now();
+    auto leases = LeaseTable(2);
+
+    REQUIRE(leases.lease(0, 2, now) == std::vector<std::size_t>{0, 1});
+    REQUIRE(leases.expire(now) == 2);
+    REQUIRE(leases.lease(1, 2, now) == std::vector<std::size_t>{0, 1});
+
+    // The node that went quiet finishes a game after all
+    REQUIRE(leases.complete(0));
+    REQUIRE(!leases.complete(0));
+    REQUIRE(leases.num_leased() == 1);
+
+    // Already finished games aren't handed out again
+    REQUIRE(leases.release(1) == 1);
+    REQUIRE(leases.lease(0, 2, now) == std::vector<std::size_t>{1});
+    REQUIRE(!leases.complete(2));
+}
@@ -0,0 +1,65 @@
+#include "core/match/resources.hpp"
+#include <doctest/doctest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+TEST_CASE("Game resources") {
+    auto engine1 = EngineSettings{};
+    engine1.options = {{"Threads", "4"}, {"Hash", "256"}};
+    auto engine2 = EngineSettings{};
+    engine2.options = {{"threads", "2"}};
+
+    // The engines take turns on the same cores
+    auto resources = game_resources(engine1, engine2);
+    REQUIRE(resources.cores == 4);
+    REQUIRE(resources.memory == 256);
+
+    // Unless they can search at the same time
+    engine2.ponder = true;
+    engine2.options.emplace_back("hash", "64");
+    resources = game_resources(engine1, engine2);
+    REQUIRE(resources.cores == 6);
+    REQUIRE(resources.memory == 320);
+}
+
+TEST_CASE("Resource budget") {
+    auto budget = ResourceBudget(8, 1024);
+    const auto small = GameResources{2, 128};
+    const auto large = GameResources{6, 512};
+    const auto huge = GameResources{16, 4096};
+
+    REQUIRE(budget.try_acquire(large));
+    REQUIRE(budget.try_acquire(small));
+
+    // Out of cores
+    REQUIRE(!budget.try_acquire(small));
+
+    budget.release(small);
+    REQUIRE(budget.try_acquire(GameResources{1, 512}));
+
+    // Out of memory
+    REQUIRE(!budget.try_acquire(GameResources{1, 1}));
+
+    // Too big to ever fit, so only played on its own
+    REQUIRE(!budget.try_acquire(huge));
+    budget.release(large);
+    budget.release(GameResources{1, 512});
+    REQUIRE(budget.try_acquire(huge));
+    REQUIRE(!budget.try_acquire(small));
+    budget.release(huge);
+
+    // Waiting for a game to finish
+    REQUIRE(budget.try_acquire(large));
+    std::atomic<bool> started = false;
+    auto thread = std::thread([&] {
+        budget.acquire(large);
+        started = true;
+        budget.release(large);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(!started);
+    budget.release(large);
+    thread.join();
+    REQUIRE(started);
+}
@@ -0,0 +1,147 @@
+#include "core/match/stats.hpp"
+#include <doctest/doctest.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <string>
+#include "core/match/results.hpp"
+#include "core/match/settings.hpp"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+[[nodiscard]] auto make_stats_settings() -> Settings {
+    auto settings = Settings{};
+    settings.engines.resize(2);
+    settings.engines[0].name = "Engine1";
+    settings.engines[1].name = "Engine2";
+    settings.sprt.enabled = true;
+    return settings;
+}
+
+TEST_CASE("Stats JSON") {
+    const auto settings = make_stats_settings();
+
+    auto results = Results{};
+    results.games_started = 12;
+    results.games_played = 10;
+    results.black_wins = 6;
+    results.white_wins = 3;
+    results.draws = 1;
+    results.pentanomial = {0, 1, 1, 2, 1};
+    results.scores["Engine1"] = Score{6, 1, 3, 0, 10};
+    results.scores["Engine2"] = Score{3, 1, 6, 2, 10};
+    results.latencies["Engine1"].move.counts[LatencyHistogram::bucket(1500)] = 4;
+    results.latencies["Engine2"];
+
+    const auto json = nlohmann::json::parse(stats_json(settings, results, 4, std::chrono::seconds(2)));
+
+    REQUIRE(json["games_played"] == 10);
+    REQUIRE(json["games_started"] == 12);
+    REQUIRE(json["games_per_second"] == 3.0);
+    REQUIRE(json["engines"]["Engine1"]["wins"] == 6);
+    REQUIRE(json["engines"]["Engine1"]["losses"] == 3);
+    REQUIRE(json["engines"]["Engine2"]["crashes"] == 2);
+    REQUIRE(json["engines"]["Engine1"]["elo"].get<float>() > 0.0f);
+    REQUIRE(json["engines"]["Engine2"]["elo"].get<float>() < 0.0f);
+    REQUIRE(json["engines"]["Engine2"]["move_ms"] == 0.0);
+
+    // Somewhere in the bucket the moves were in
+    const auto move_ms = json["engines"]["Engine1"]["move_ms"].get<double>();
+    REQUIRE(move_ms >= 1.024);
+    REQUIRE(move_ms <= 2.048);
+
+    REQUIRE(json.contains("sprt"));
+    REQUIRE(json["sprt"]["llr"].get<float>() > 0.0f);
+    REQUIRE(json["sprt"]["pentanomial"] == std::array<int, 5>{0, 1, 1, 2, 1});
+}
+
+#ifndef _WIN32
+
+// Returns an empty string if we couldn't talk to the server
+[[nodiscard]] auto read_stats(const std::string &path, const std::string &request) -> std::string {
+    const auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return {};
+    }
+
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    std::string reply;
+    if (connect(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) == 0 &&
+        write(fd, request.data(), request.size()) == static_cast<ssize_t>(request.size())) {
+        char buffer[256];
+        ssize_t n = 0;
+        while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+            reply.append(buffer, static_cast<std::size_t>(n));
+        }
+    }
+    close(fd);
+
+    return reply;
+}
+
+TEST_CASE("Stats server") {
+    const auto path = "cuteataxx-test-" + std::to_string(getpid()) + ".sock";
+    std::atomic<int> num_made = 0;
+
+    {
+        const auto server = StatsServer(path, std::chrono::hours(1), [&num_made] {
+            return "{\"made\":" + std::to_string(++num_made) + "}";
+        });
+
+        // Plain
+        REQUIRE(read_stats(path, "") == "{\"made\":1}");
+
+        // HTTP, and not rebuilt within the interval
+        const auto reply = read_stats(path, "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+        REQUIRE(reply.starts_with("HTTP/1.0 200 OK\r\n"));
+        REQUIRE(reply.ends_with("\r\n\r\n{\"made\":1}"));
+        REQUIRE(num_made == 1);
+    }
+
+    // Cleaned up after itself
+    REQUIRE(access(path.c_str(), F_OK) != 0);
+}
+
+TEST_CASE("Stats server - existing path") {
+    const auto path = "cuteataxx-test-" + std::to_string(getpid()) + "-existing.sock";
+    const auto make_stats = [] {
+        return std::string("{}");
+    };
+
+    // Not ours to delete
+    {
+        std::ofstream f(path);
+        f << "important";
+    }
+    REQUIRE_THROWS(StatsServer(path, std::chrono::hours(1), make_stats));
+    REQUIRE(access(path.c_str(), F_OK) == 0);
+    unlink(path.c_str());
+
+    // A socket left behind by a match that didn't exit cleanly is replaced
+    {
+        const auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        auto addr = sockaddr_un{};
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        REQUIRE(bind(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) == 0);
+        close(fd);
+    }
+    REQUIRE(access(path.c_str(), F_OK) == 0);
+    {
+        const auto server = StatsServer(path, std::chrono::hours(1), make_stats);
+        REQUIRE(read_stats(path, "") == "{}");
+    }
+    REQUIRE(access(path.c_str(), F_OK) != 0);
+}
+
+#endif
@@ -0,0 +1,80 @@
+#include "core/match/tally.hpp"
+#include <doctest/doctest.h>
+#include <array>
+#include <string>
+#include <vector>
+
+TEST_CASE("Results tally - crashes") {
+    auto tally = ResultsTally({"Engine1", "Engine2"}, 2);
+
+    tally.played(0, 0, 1, libataxx::Result::BlackWin, ResultReason::EngineCrash);
+    tally.played(1, 1, 0, libataxx::Result::BlackWin, ResultReason::EngineCrash);
+    tally.played(1, 0, 1, libataxx::Result::WhiteWin, ResultReason::OutOfTime);
+
+    const auto results = tally.snapshot();
+    REQUIRE(results.games_played == 3);
+    REQUIRE(results.scores.at("Engine1").crashes == 1);
+    REQUIRE(results.scores.at("Engine2").crashes == 1);
+}
+
+TEST_CASE("Results tally - aborted games") {
+    auto tally = ResultsTally({"Engine1", "Engine2"}, 2);
+
+    tally.started(0);
+    tally.started(1);
+    tally.played(0, 0, 1, libataxx::Result::Draw, ResultReason::Normal);
+    tally.aborted(1);
+
+    const auto results = tally.snapshot();
+    REQUIRE(results.games_started == 1);
+    REQUIRE(results.games_played == 1);
+}
+
+TEST_CASE("Results tally - pairs") {
+    auto tally = ResultsTally({"Engine1", "Engine2"}, 2, 7);
+
+    // Engine1 wins both games
+    tally.paired(0, 0, 0, libataxx::Result::BlackWin);
+    REQUIRE(tally.snapshot().pentanomial == std::array<int, 5>{0, 0, 0, 0, 0});
+    tally.paired(1, 1, 1, libataxx::Result::WhiteWin);
+    REQUIRE(tally.snapshot().pentanomial == std::array<int, 5>{0, 0, 0, 0, 1});
+
+    // A loss and a draw, finishing out of order
+    tally.paired(0, 3, 1, libataxx::Result::BlackWin);
+    tally.paired(1, 2, 0, libataxx::Result::Draw);
+    REQUIRE(tally.snapshot().pentanomial == std::array<int, 5>{0, 1, 0, 0, 1});
+
+    // The last game doesn't have a pair
+    tally.paired(0, 6, 0, libataxx::Result::Draw);
+    REQUIRE(tally.sprt_snapshot().pentanomial == std::array<int, 5>{0, 1, 0, 0, 1});
+
+    // Carrying on with a pair that was half finished
+    auto resumed = ResultsTally({"Engine1", "Engine2"}, 1, 7);
+    resumed.restore(tally.snapshot(), {{2, 1}});
+    resumed.paired(0, 5, 1, libataxx::Result::WhiteWin);
+    REQUIRE(resumed.snapshot().pentanomial == std::array<int, 5>{0, 1, 0, 1, 1});
+}
+
+TEST_CASE("Results tally - updates") {
+    auto tally = ResultsTally({"Engine1", "Engine2"}, 2, 25);
+
+    for (std::size_t i = 0; i < 3; ++i) {
+        tally.started(i % 2);
+        tally.played(i % 2, 0, 1, libataxx::Result::Draw, ResultReason::Normal);
+    }
+    REQUIRE(tally.games_played() == 3);
+
+    // Once per interval, however many games see it
+    REQUIRE(!tally.is_update_due(5, 10));
+    REQUIRE(tally.is_update_due(10, 10));
+    REQUIRE(!tally.is_update_due(10, 10));
+    REQUIRE(!tally.is_update_due(13, 10));
+
+    // Games that finished at the same time can skip past an interval
+    REQUIRE(tally.is_update_due(21, 10));
+    REQUIRE(!tally.is_update_due(20, 10));
+
+    // And once the last game is played
+    REQUIRE(tally.is_update_due(25, 10));
+    REQUIRE(!tally.is_update_due(25, 10));
+}
@@ -0,0 +1,78 @@
+#include "core/match/worker.hpp"
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include "core/match/settings.hpp"
+#include "core/match/stop.hpp"
+#include "core/opening_book.hpp"
+#include "core/tournament/roundrobin.hpp"
+
+[[nodiscard]] auto make_worker_settings() -> Settings {
+    auto settings = Settings{};
+    settings.engines.push_back(
+        EngineSettings{0, EngineProtocol::Unknown, "Most", "mostcaptures", "", "", SearchSettings::as_depth(1), {}});
+    settings.engines.push_back(
+        EngineSettings{1, EngineProtocol::Unknown, "Least", "leastcaptures", "", "", SearchSettings::as_depth(1), {}});
+    return settings;
+}
+
+TEST_CASE("Worker - every game claimed once") {
+    const auto settings = make_worker_settings();
+    const auto openings = OpeningBook();
+    const auto generator = RoundRobinGenerator(2, 20000, 1, true);
+    const auto callbacks = Callbacks{};
+    const auto slot_cores = std::vector<std::vector<int>>{};
+    const auto context = MatchContext{settings, openings, generator, callbacks, slot_cores};
+    const auto stop = StopToken{};
+    std::atomic<std::size_t> next_game = 0;
+
+    std::vector<std::vector<std::size_t>> claimed(4);
+    std::vector<std::thread> threads;
+    for (auto &ids : claimed) {
+        threads.emplace_back([&context, &next_game, &stop, &ids] {
+            while (const auto game_info = claim_game(context, next_game, stop)) {
+                ids.push_back(game_info->id);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::vector<std::size_t> all;
+    for (const auto &ids : claimed) {
+        all.insert(all.end(), ids.begin(), ids.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    std::vector<std::size_t> expected(generator.expected());
+    std::iota(expected.begin(), expected.end(), 0);
+    REQUIRE(all == expected);
+}
+
+TEST_CASE("Worker - claiming once the match is stopping") {
+    const auto settings = make_worker_settings();
+    const auto openings = OpeningBook();
+    const auto generator = RoundRobinGenerator(2, 8, 1, true);
+    const auto callbacks = Callbacks{};
+    const auto slot_cores = std::vector<std::vector<int>>{};
+    const auto context = MatchContext{settings, openings, generator, callbacks, slot_cores};
+    auto stop = StopToken{};
+    std::atomic<std::size_t> next_game = 0;
+
+    REQUIRE(claim_game(context, next_game, stop)->id == 0);
+
+    // The other half of the pair is still played, but nothing new
+    stop.finish();
+    REQUIRE(claim_game(context, next_game, stop)->id == 1);
+    REQUIRE(!claim_game(context, next_game, stop));
+    REQUIRE(next_game == 2);
+
+    // Not even the other half
+    next_game = 3;
+    stop.abort();
+    REQUIRE(!claim_game(context, next_game, stop));
+}
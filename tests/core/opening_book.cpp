@@ -0,0 +1,116 @@
+#include "core/opening_book.hpp"
+#include <algorithm>
+#include <doctest/doctest.h>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_CASE("Opening book - default") {
+    const auto book = OpeningBook();
+    REQUIRE(book.size() == 1);
+    REQUIRE(book[0] == "x5o/7/7/7/7/7/o5x x 0 1");
+    REQUIRE(book.position(0).get_fen() == "x5o/7/7/7/7/7/o5x x 0 1");
+}
+
+TEST_CASE("Opening book - file") {
+    const auto path = (std::filesystem::temp_directory_path() / "cuteataxx_test_book.txt").string();
+
+    {
+        std::ofstream f(path, std::ios::binary);
+        f << "# comment\n";
+        f << "x5o/7/7/7/7/7/o5x x 0 1\n";
+        f << "\n";
+        f << "x5o/7/2-1-2/7/2-1-2/7/o5x x 0 1\r\n";
+        f << "short\n";
+        f << "x5o/7/7/7/7/7/o5x o 0 1";
+    }
+
+    const auto expected = std::set<std::string>{
+        "x5o/7/7/7/7/7/o5x x 0 1",
+        "x5o/7/2-1-2/7/2-1-2/7/o5x x 0 1",
+        "x5o/7/7/7/7/7/o5x o 0 1",
+    };
+
+    for (const auto cache_index : {false, true, true}) {
+        auto book = OpeningBook(path, cache_index);
+        REQUIRE(book.size() == 3);
+        REQUIRE(book[0] == "x5o/7/7/7/7/7/o5x x 0 1");
+        REQUIRE(book[1] == "x5o/7/2-1-2/7/2-1-2/7/o5x x 0 1");
+        REQUIRE(book[2] == "x5o/7/7/7/7/7/o5x o 0 1");
+
+        REQUIRE(book.position(2).get_turn() == libataxx::Side::White);
+
+        // Shuffling keeps every position, and each one stays with its line
+        // In the same order as shuffling the lines themselves
+        auto lines = std::vector<std::string>{std::string(book[0]), std::string(book[1]), std::string(book[2])};
+        std::shuffle(lines.begin(), lines.end(), std::mt19937(123));
+
+        book.shuffle(123);
+        for (std::size_t i = 0; i < book.size(); ++i) {
+            REQUIRE(book[i] == lines[i]);
+        }
+
+        std::set<std::string> found;
+        for (std::size_t i = 0; i < book.size(); ++i) {
+            found.emplace(book[i]);
+            REQUIRE(book.position(i).get_fen() == book[i]);
+        }
+        REQUIRE(found == expected);
+    }
+
+    REQUIRE(std::filesystem::exists(path + ".idx"));
+    std::filesystem::remove(path + ".idx");
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Opening book - invalid FEN") {
+    const auto path = (std::filesystem::temp_directory_path() / "cuteataxx_test_bad_book.txt").string();
+
+    {
+        std::ofstream f(path, std::ios::binary);
+        f << "# comment\n";
+        f << "x5o/7/7/7/7/7/o5x x 0 1\n";
+        f << "x5o/7/7/7/7/7/o5x z 0 1\n";
+    }
+
+    std::string error;
+    try {
+        const auto book = OpeningBook(path);
+    } catch (const std::invalid_argument &e) {
+        error = e.what();
+    }
+    REQUIRE(error.find("line 3") != std::string::npos);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Opening book - deduplicate") {
+    const auto path = (std::filesystem::temp_directory_path() / "cuteataxx_test_dup_book.txt").string();
+
+    {
+        std::ofstream f(path, std::ios::binary);
+        f << "x5o/7/7/7/7/7/oo2xxx o 0 2\n";
+        f << "x5o/7/7/7/7/4x2/oo3xx o 0 2\n";
+        // Mirrored, then with the colours swapped too
+        f << "o5x/7/7/7/7/7/xxx2oo o 0 2\n";
+        f << "o5x/7/7/7/7/7/xx2ooo x 0 2\n";
+        f << "x5o/7/7/7/7/7/o5x x 0 1\n";
+    }
+
+    auto book = OpeningBook(path);
+    book.deduplicate();
+    REQUIRE(book.size() == 3);
+    REQUIRE(book.num_duplicates() == 2);
+    REQUIRE(book[0] == "x5o/7/7/7/7/7/oo2xxx o 0 2");
+    REQUIRE(book[1] == "x5o/7/7/7/7/4x2/oo3xx o 0 2");
+    REQUIRE(book[2] == "x5o/7/7/7/7/7/o5x x 0 1");
+    for (std::size_t i = 0; i < book.size(); ++i) {
+        REQUIRE(book.position(i).get_fen() == book[i]);
+    }
+
+    std::filesystem::remove(path);
+}
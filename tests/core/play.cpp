@@ -1,5 +1,7 @@
 #include "core/play.hpp"
 #include <doctest/doctest.h>
+#include "core/ataxx/parse_move.hpp"
+#include "core/engine/builtin/builtin.hpp"
 #include "core/engine/builtin/most_captures.hpp"
 #include "core/engine/create.hpp"
 #include "core/engine/settings.hpp"
@@ -16,8 +18,9 @@ TEST_CASE("Test 1") {
     std::shared_ptr<Engine> mostcaptures2;
     mostcaptures2 = make_engine(settings2, {}, {});
 
-    const auto adjudication = AdjudicationSettings{{}, {}, {}, 0};
-    const auto game = GameSettings{"startpos", settings1, settings2};
+    const auto adjudication = AdjudicationSettings{{}, {}, {}, 0, {}};
+    const auto startpos = libataxx::Position("startpos");
+    const auto game = GameSettings{startpos, settings1, settings2};
 
     const auto result1 = play(adjudication, game, mostcaptures1, mostcaptures2);
     const auto result2 = play(adjudication, game, mostcaptures2, mostcaptures1);
@@ -44,3 +47,57 @@ TEST_CASE("Test 1") {
     }
     REQUIRE(pos.get_hash() == result1.endpos.get_hash());
 }
+
+TEST_CASE("Builtin search agrees with go") {
+    const auto settings1 =
+        EngineSettings{0, EngineProtocol::Unknown, "Test1", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+    const auto settings2 =
+        EngineSettings{1, EngineProtocol::Unknown, "Test2", "leastcaptures", "", "", SearchSettings::as_depth(1), {}};
+
+    const auto engine1 = make_engine(settings1, {}, {});
+    const auto engine2 = make_engine(settings2, {}, {});
+    const auto adjudication = AdjudicationSettings{{}, {}, {}, 0, {}};
+    const auto startpos = libataxx::Position("startpos");
+    const auto game = GameSettings{startpos, settings1, settings2};
+    const auto result = play(adjudication, game, engine1, engine2);
+
+    REQUIRE(!result.history.empty());
+
+    auto pos = result.startpos;
+    for (const auto &move_info : result.history) {
+        auto &engine = pos.get_turn() == libataxx::Side::Black ? engine1 : engine2;
+        auto *const builtin = dynamic_cast<BuiltinEngine *>(engine.get());
+        REQUIRE(builtin);
+
+        engine->position(pos);
+        REQUIRE(parse_move(engine->go(SearchSettings::as_depth(1))) == move_info.move);
+        REQUIRE(builtin->search(pos, SearchSettings::as_depth(1)) == move_info.move);
+        pos.makemove(move_info.move);
+    }
+}
+
+TEST_CASE("Aborted games have no result") {
+    const auto settings1 =
+        EngineSettings{0, EngineProtocol::Unknown, "Test1", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+    const auto settings2 =
+        EngineSettings{1, EngineProtocol::Unknown, "Test2", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+
+    const auto engine1 = make_engine(settings1, {}, {});
+    const auto engine2 = make_engine(settings2, {}, {});
+    const auto adjudication = AdjudicationSettings{{}, {}, {}, 0, {}};
+    const auto startpos = libataxx::Position("startpos");
+    const auto game = GameSettings{startpos, settings1, settings2};
+
+    const std::atomic<bool> abort = true;
+    const auto aborted = play(adjudication, game, engine1, engine2, &abort);
+    REQUIRE(aborted.reason == ResultReason::Aborted);
+    REQUIRE(aborted.result == libataxx::Result::None);
+    REQUIRE(aborted.history.empty());
+    REQUIRE(aborted.endpos.get_hash() == startpos.get_hash());
+
+    // Engines can carry on playing afterwards
+    const std::atomic<bool> carry_on = false;
+    const auto finished = play(adjudication, game, engine1, engine2, &carry_on);
+    REQUIRE(finished.reason != ResultReason::Aborted);
+    REQUIRE(finished.endpos.is_gameover());
+}
@@ -126,4 +126,34 @@ TEST_SUITE("Tournament - Gauntlet") {
         REQUIRE(gen.next() == GameInfo{8, 0, 0, 1});
         REQUIRE(gen.next() == GameInfo{9, 1, 0, 1});
     }
+
+    TEST_CASE("Game at index") {
+        auto gen = GauntletGenerator(3, 4, 4, true);
+        REQUIRE(gen.expected() == 8);
+
+        // Out of order, the same games as in Test 4
+        REQUIRE(gen.game_at(7) == GameInfo{7, 1, 2, 0});
+        REQUIRE(gen.game_at(2) == GameInfo{2, 1, 0, 1});
+        REQUIRE(gen.game_at(5) == GameInfo{5, 0, 2, 0});
+        REQUIRE(gen.game_at(0) == GameInfo{0, 0, 0, 1});
+
+        // Overflow
+        REQUIRE(gen.game_at(11) == GameInfo{11, 1, 1, 0});
+        REQUIRE(gen.game_at(806) == GameInfo{806, 1, 0, 2});
+
+        // Nothing was changed
+        REQUIRE(gen.next() == GameInfo{0, 0, 0, 1});
+    }
+
+    TEST_CASE("Game at index no repeat") {
+        auto gen = GauntletGenerator(3, 3, 2, false);
+        REQUIRE(gen.expected() == 6);
+
+        REQUIRE(gen.game_at(5) == GameInfo{5, 0, 0, 2});
+        REQUIRE(gen.game_at(4) == GameInfo{4, 1, 0, 2});
+        REQUIRE(gen.game_at(1) == GameInfo{1, 1, 0, 1});
+
+        // Overflow
+        REQUIRE(gen.game_at(7) == GameInfo{7, 1, 0, 1});
+    }
 }
@@ -0,0 +1,38 @@
+#include "core/tournament/resume.hpp"
+#include <doctest/doctest.h>
+#include <memory>
+#include "core/tournament/roundrobin.hpp"
+
+TEST_SUITE("Tournament - Resume") {
+    TEST_CASE("Nothing finished") {
+        const auto inner = std::make_shared<RoundRobinGenerator>(3, 4, 2, true);
+        auto gen = ResumeGenerator(inner, 0, {});
+
+        REQUIRE(gen.expected() == inner->expected());
+        for (std::size_t i = 0; i < inner->expected(); ++i) {
+            REQUIRE(gen.next() == inner->game_at(i));
+        }
+        REQUIRE(gen.is_finished());
+    }
+
+    TEST_CASE("Gaps first") {
+        const auto inner = std::make_shared<RoundRobinGenerator>(3, 4, 2, true);
+        auto gen = ResumeGenerator(inner, 2, {3, 5, 6});
+
+        REQUIRE(gen.expected() == inner->expected() - 5);
+        REQUIRE(gen.next() == inner->game_at(2));
+        REQUIRE(gen.next() == inner->game_at(4));
+        for (std::size_t i = 7; i < inner->expected(); ++i) {
+            REQUIRE(gen.next() == inner->game_at(i));
+        }
+        REQUIRE(gen.is_finished());
+    }
+
+    TEST_CASE("Everything finished") {
+        const auto inner = std::make_shared<RoundRobinGenerator>(2, 4, 2, true);
+        auto gen = ResumeGenerator(inner, inner->expected(), {});
+
+        REQUIRE(gen.expected() == 0);
+        REQUIRE(gen.is_finished());
+    }
+}
@@ -172,4 +172,37 @@ TEST_SUITE("Tournament - Round Robin") {
         REQUIRE(gen.next() == GameInfo{12, 0, 0, 1});
         REQUIRE(gen.next() == GameInfo{13, 1, 0, 1});
     }
+
+    TEST_CASE("Game at index") {
+        auto gen = RoundRobinGenerator(4, 4, 2, true);
+        REQUIRE(gen.expected() == 24);
+
+        // Out of order, the same games as in Test 4
+        REQUIRE(gen.game_at(23) == GameInfo{23, 1, 3, 2});
+        REQUIRE(gen.game_at(13) == GameInfo{13, 0, 2, 1});
+        REQUIRE(gen.game_at(6) == GameInfo{6, 1, 0, 2});
+        REQUIRE(gen.game_at(18) == GameInfo{18, 1, 1, 3});
+        REQUIRE(gen.game_at(0) == GameInfo{0, 0, 0, 1});
+
+        // Overflow
+        REQUIRE(gen.game_at(25) == GameInfo{25, 0, 1, 0});
+        REQUIRE(gen.game_at(185) == GameInfo{185, 0, 3, 1});
+
+        // Nothing was changed
+        REQUIRE(gen.next() == GameInfo{0, 0, 0, 1});
+    }
+
+    TEST_CASE("Game at index no repeat") {
+        auto gen = RoundRobinGenerator(4, 2, 2, false);
+        REQUIRE(gen.expected() == 12);
+
+        // The same games as in Test no repeat 2
+        REQUIRE(gen.game_at(11) == GameInfo{11, 1, 2, 3});
+        REQUIRE(gen.game_at(6) == GameInfo{6, 0, 1, 2});
+        REQUIRE(gen.game_at(3) == GameInfo{3, 1, 0, 2});
+
+        // Overflow
+        REQUIRE(gen.game_at(13) == GameInfo{13, 1, 0, 1});
+        REQUIRE(gen.game_at(130) == GameInfo{130, 0, 2, 3});
+    }
 }
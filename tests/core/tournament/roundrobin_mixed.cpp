@@ -309,4 +309,36 @@ TEST_SUITE("Tournament - Round Robin Mixed") {
             }
         }
     }
+
+    TEST_CASE("Game at index") {
+        auto gen = RoundRobinMixedGenerator(4, 4, 4, true);
+        REQUIRE(gen.expected() == 24);
+
+        // Out of order, the same games as in Test 4
+        REQUIRE(gen.game_at(23) == GameInfo{23, 3, 3, 2});
+        REQUIRE(gen.game_at(6) == GameInfo{6, 3, 3, 1});
+        REQUIRE(gen.game_at(13) == GameInfo{13, 2, 3, 0});
+        REQUIRE(gen.game_at(20) == GameInfo{20, 2, 0, 1});
+        REQUIRE(gen.game_at(0) == GameInfo{0, 0, 0, 3});
+
+        // Overflow
+        REQUIRE(gen.game_at(25) == GameInfo{25, 0, 3, 0});
+        REQUIRE(gen.game_at(91) == GameInfo{91, 1, 1, 3});
+
+        // Nothing was changed
+        REQUIRE(gen.next() == GameInfo{0, 0, 0, 3});
+    }
+
+    TEST_CASE("Game at index no repeat") {
+        auto gen = RoundRobinMixedGenerator(4, 2, 2, false);
+        REQUIRE(gen.expected() == 12);
+
+        // The pairings from Test 3, one game each
+        REQUIRE(gen.game_at(11) == GameInfo{11, 1, 2, 3});
+        REQUIRE(gen.game_at(4) == GameInfo{4, 0, 0, 1});
+        REQUIRE(gen.game_at(3) == GameInfo{3, 1, 3, 1});
+
+        // Overflow
+        REQUIRE(gen.game_at(13) == GameInfo{13, 1, 1, 2});
+    }
 }